@@ -2,13 +2,16 @@ from __future__ import annotations
 
 import hashlib
 import io
+import json
 import logging
-from pathlib import Path
+from pathlib import Path, PurePosixPath
 import re
+import struct
+import zlib
 
-from PIL import Image, UnidentifiedImageError
+from PIL import Image, ImageChops, UnidentifiedImageError
 
-from esphome import core, external_files
+from esphome import automation, core, external_files
 import esphome.codegen as cg
 from esphome.components.const import CONF_BYTE_ORDER
 import esphome.config_validation as cv
@@ -22,10 +25,17 @@ from esphome.const import (
     CONF_RAW_DATA_ID,
     CONF_RESIZE,
     CONF_SOURCE,
+    CONF_TRIGGER_ID,
     CONF_TYPE,
     CONF_URL,
 )
 from esphome.core import CORE, HexInt
+from esphome.coroutine import coroutine_with_priority
+
+try:
+    import numpy as np
+except ImportError:  # numpy is optional: chroma key images fall back to per-pixel encoding
+    np = None
 
 _LOGGER = logging.getLogger(__name__)
 
@@ -41,6 +51,57 @@ CONF_CHROMA_KEY = "chroma_key"
 CONF_ALPHA_CHANNEL = "alpha_channel"
 CONF_INVERT_ALPHA = "invert_alpha"
 CONF_IMAGES = "images"
+CONF_CACHE_ENABLED = "cache_enabled"
+CONF_PRELOAD = "preload"
+CONF_STREAM_BAND_HEIGHT = "stream_band_height"
+CONF_ASYNC_LOAD = "async_load"
+CONF_DOUBLE_BUFFER = "double_buffer"
+CONF_BUFFER_PLACEMENT = "buffer_placement"
+CONF_MEMORY_BUDGET = "memory_budget"
+CONF_SD_EXPORT = "sd_export"
+CONF_SD_COMPRESSION = "sd_compression"
+CONF_SD_ROW_INDEX = "sd_row_index"
+CONF_SD_PALETTE = "sd_palette"
+CONF_ON_LOAD_COMPLETE = "on_load_complete"
+CONF_ON_LOAD_ERROR = "on_load_error"
+CONF_SD_IMAGE_ID = "sd_image_id"
+CONF_STORAGE_ID = "storage_id"
+CONF_FILE_PATH = "file_path"
+
+# Flash not spent on placeholder arrays for runtime SD images (CORE.data[DOMAIN])
+KEY_SD_FLASH_SAVED = "sd_flash_saved"
+# Encoded image cache statistics and end-of-codegen report (CORE.data[DOMAIN])
+KEY_CACHE_HITS = "cache_hits"
+KEY_CACHE_MISSES = "cache_misses"
+KEY_REPORT_SCHEDULED = "report_scheduled"
+# The memory budget is global on the device: emitted once (CORE.data[DOMAIN])
+KEY_MEMORY_BUDGET_SET = "memory_budget_set"
+# Pixel bytes of exported SD images, and bytes actually stored once compressed
+KEY_SD_EXPORT_BYTES = "sd_export_bytes"
+KEY_SD_EXPORT_STORED = "sd_export_stored"
+
+# Bump when the encoders change their output, to invalidate cached images
+ENCODED_CACHE_VERSION = 1
+
+# Self-describing container of exported SD images, parsed by ImageAssetHeader
+# (image_asset.h): a 64-byte little-endian header, then the pixels at an
+# offset aligned to a 512-byte SD sector
+SD_ASSET_MAGIC = b"SDIM"
+SD_ASSET_VERSION = 2
+SD_ASSET_HEADER_SIZE = 64
+SD_ASSET_ALIGNMENT = 512
+SD_ASSET_FLAG_CRC = 0x01
+SD_ASSET_FLAG_ROW_INDEX = 0x02
+SD_ASSET_FORMATS = {
+    "RGB565": 0,
+    "RGB888": 1,
+    "RGBA": 2,
+    "GRAYSCALE": 3,
+    "BINARY": 4,
+    "INDEXED": 5,
+}
+SD_ASSET_ALPHA_MODES = {CONF_OPAQUE: 0, CONF_ALPHA_CHANNEL: 1, CONF_CHROMA_KEY: 2}
+SD_ASSET_COMPRESSIONS = {"NONE": 0, "RLE": 1}
 
 TRANSPARENCY_TYPES = (
     CONF_OPAQUE,
@@ -81,7 +142,7 @@ class ImageEncoder:
         self.transparency = transparency
         self.width = width
         self.height = height
-        self.data = [0 for _ in range(width * height)]
+        self.data = bytearray(width * height)
         self.dither = dither
         self.index = 0
         self.invert_alpha = invert_alpha
@@ -107,6 +168,26 @@ class ImageEncoder:
         :return:
         """
 
+    def encode_frame(self, image):
+        """
+        Encode a whole converted frame. Subclasses override this with bulk
+        buffer operations; this reference version encodes pixel by pixel.
+        :param image:  Image returned by convert(), already resized
+        """
+        pixels = image.getdata()
+        width, height = image.size
+        for row in range(height):
+            for col in range(width):
+                self.encode(pixels[row * width + col])
+            self.end_row()
+
+    def append(self, data):
+        """
+        Copy already encoded bytes at the current position
+        """
+        self.data[self.index : self.index + len(data)] = data
+        self.index += len(data)
+
 
 def is_alpha_only(image: Image):
     """
@@ -149,6 +230,16 @@ class ImageBinary(ImageEncoder):
             self.bitno = 0
             self.index += 1
 
+    def encode_frame(self, image):
+        # Mode "1" is already packed MSB first, each row padded to a byte
+        if self.invert_alpha:
+            image = (
+                image.convert("L")
+                .point(lambda v: v ^ 0xFF)
+                .convert("1", dither=Image.Dither.NONE)
+            )
+        self.append(image.tobytes())
+
 
 class ImageGrayscale(ImageEncoder):
     allow_config = {CONF_ALPHA_CHANNEL, CONF_CHROMA_KEY, CONF_INVERT_ALPHA, CONF_OPAQUE}
@@ -180,6 +271,29 @@ class ImageGrayscale(ImageEncoder):
         self.data[self.index] = b
         self.index += 1
 
+    def encode_frame(self, image):
+        if self.transparency == CONF_CHROMA_KEY:
+            if np is None:
+                super().encode_frame(image)
+                return
+            pixels = np.array(image)
+            gray, alpha = pixels[..., 0], pixels[..., 1]
+            gray[gray == 1] = 0
+            gray[alpha != 0xFF] = 1
+            if self.invert_alpha:
+                gray ^= 0xFF
+            self.append(gray.tobytes())
+            return
+        gray, alpha = image.split()
+        if self.invert_alpha:
+            gray = gray.point(lambda v: v ^ 0xFF)
+        if self.transparency == CONF_ALPHA_CHANNEL:
+            # Translucent pixels store their alpha instead of the gray level
+            gray = Image.composite(
+                alpha, gray, alpha.point(lambda v: 0 if v == 0xFF else 0xFF)
+            )
+        self.append(gray.tobytes())
+
 
 class ImageRGB565(ImageEncoder):
     def __init__(self, width, height, transparency, dither, invert_alpha):
@@ -228,6 +342,40 @@ class ImageRGB565(ImageEncoder):
             self.data[self.index] = a
             self.index += 1
 
+    def encode_frame(self, image):
+        if self.transparency == CONF_CHROMA_KEY:
+            if np is None:
+                super().encode_frame(image)
+                return
+            pixels = np.asarray(image, dtype=np.uint16)
+            r = pixels[..., 0] >> 3
+            g = pixels[..., 1] >> 2
+            b = pixels[..., 2] >> 3
+            key = (r == 0) & (g == 1) & (b == 0)
+            transparent = ~key & (pixels[..., 3] < 128)
+            g[key] = 0
+            r[transparent] = 0
+            g[transparent] = 1
+            b[transparent] = 0
+            rgb = (r << 11) | (g << 5) | b
+            self.append(rgb.astype(">u2" if self.big_endian else "<u2").tobytes())
+            return
+        red, green, blue, alpha = image.split()
+        # RGB565 split in its two bytes; the bit fields never overlap so add() is an OR
+        high = ImageChops.add(
+            red.point(lambda v: v & 0xF8), green.point(lambda v: v >> 5)
+        )
+        low = ImageChops.add(
+            green.point(lambda v: (v << 3) & 0xE0), blue.point(lambda v: v >> 3)
+        )
+        bands = (high, low) if self.big_endian else (low, high)
+        if self.transparency == CONF_ALPHA_CHANNEL:
+            if self.invert_alpha:
+                alpha = alpha.point(lambda v: v ^ 0xFF)
+            self.append(Image.merge("RGB", (*bands, alpha)).tobytes())
+        else:
+            self.append(Image.merge("LA", bands).tobytes())
+
 
 class ImageRGB(ImageEncoder):
     def __init__(self, width, height, transparency, dither, invert_alpha):
@@ -264,6 +412,83 @@ class ImageRGB(ImageEncoder):
             self.data[self.index] = a
             self.index += 1
 
+    def encode_frame(self, image):
+        if self.transparency == CONF_CHROMA_KEY:
+            if np is None:
+                super().encode_frame(image)
+                return
+            pixels = np.array(image)
+            r, g, b = pixels[..., 0], pixels[..., 1], pixels[..., 2]
+            key = (r == 0) & (g == 1) & (b == 0)
+            transparent = ~key & (pixels[..., 3] < 128)
+            g[key] = 0
+            r[transparent] = 0
+            g[transparent] = 1
+            b[transparent] = 0
+            self.append(pixels[..., :3].tobytes())
+            return
+        red, green, blue, alpha = image.split()
+        if self.transparency == CONF_ALPHA_CHANNEL:
+            if self.invert_alpha:
+                alpha = alpha.point(lambda v: v ^ 0xFF)
+            self.append(Image.merge("RGBA", (red, green, blue, alpha)).tobytes())
+        else:
+            self.append(Image.merge("RGB", (red, green, blue)).tobytes())
+
+
+class ImageIndexed(ImageEncoder):
+    """
+    Palette of up to 256 RGBA colors, and 1, 2, 4 or 8-bit indices packed MSB first
+    with each row padded to a byte. Only produced for exported SD images
+    (sd_palette): ESPHome images have no indexed type.
+    """
+
+    def __init__(self, width, height, transparency, dither, invert_alpha, colors=256):
+        self.colors = colors
+        self.bits = next(bits for bits in (1, 2, 4, 8) if 1 << bits >= colors)
+        super().__init__(
+            (width * self.bits + 7) // 8,
+            height,
+            transparency,
+            dither,
+            invert_alpha,
+        )
+        # RGBA entries, filled by encode_frame()
+        self.palette = []
+
+    def convert(self, image, path):
+        image = image.convert("RGBA")
+        if self.transparency == CONF_OPAQUE:
+            return image.convert("RGB").quantize(self.colors, dither=self.dither)
+        alpha = image.getchannel("A")
+        if self.transparency == CONF_CHROMA_KEY:
+            alpha = alpha.point(lambda v: 0xFF if v >= 128 else 0)
+        elif self.invert_alpha:
+            alpha = alpha.point(lambda v: v ^ 0xFF)
+        # Fully transparent pixels share one entry whatever their color
+        visible = alpha.point(lambda v: 0xFF if v else 0)
+        image = Image.composite(image, Image.new("RGBA", image.size), visible)
+        image.putalpha(alpha)
+        return image.quantize(
+            self.colors, method=Image.Quantize.FASTOCTREE, dither=self.dither
+        )
+
+    def encode_frame(self, image):
+        # Only the entries actually used are kept, indices sized for them
+        used = image.getextrema()[1] + 1
+        palette = image.getpalette("RGBA") or []
+        self.palette = [tuple(palette[i * 4 : i * 4 + 4]) for i in range(used)]
+        bits = next(bits for bits in (1, 2, 4, 8) if 1 << bits >= used)
+        if bits != self.bits:
+            self.bits = bits
+            self.width = (image.size[0] * bits + 7) // 8
+            self.data = bytearray(self.width * self.height)
+        if self.bits == 8:
+            self.append(image.tobytes())
+        else:
+            # Pillow packs P;1/P;2/P;4 rows MSB first, padded to a byte
+            self.append(image.tobytes("raw", f"P;{self.bits}"))
+
 
 class ReplaceWith:
     """
@@ -314,6 +539,24 @@ MDI_SOURCES = {
 
 Image_ = image_ns.class_("Image")
 
+storage_ns = cg.esphome_ns.namespace("storage")
+StorageComponent = storage_ns.class_("StorageComponent", cg.Component)
+SdImageComponent = storage_ns.class_("SdImageComponent", cg.Component)
+BufferPlacement = storage_ns.enum("BufferPlacement", is_class=True)
+BUFFER_PLACEMENTS = {
+    "AUTO": BufferPlacement.automatic,
+    "PSRAM": BufferPlacement.psram,
+    "INTERNAL": BufferPlacement.internal,
+}
+SdImageLoadCompleteTrigger = storage_ns.class_(
+    "SdImageLoadCompleteTrigger", automation.Trigger.template()
+)
+SdImageLoadErrorTrigger = storage_ns.class_(
+    "SdImageLoadErrorTrigger", automation.Trigger.template()
+)
+SdImageLoadAction = storage_ns.class_("SdImageLoadAction", automation.Action)
+SdImageUnloadAction = storage_ns.class_("SdImageUnloadAction", automation.Action)
+
 INSTANCE_TYPE = Image_
 
 
@@ -502,6 +745,14 @@ def validate_settings(value):
         
         # Pour les fichiers SD card, on évite la validation locale
         if file_path.startswith("sd_card/") or file_path.startswith("sd_card//"):
+            if value.get(CONF_STORAGE_ID) is None:
+                raise cv.Invalid(
+                    f"'{CONF_STORAGE_ID}' is required to read {file_path} at runtime"
+                )
+            if CONF_STREAM_BAND_HEIGHT in value and value.get(CONF_CACHE_ENABLED, True):
+                raise cv.Invalid(
+                    f"'{CONF_STREAM_BAND_HEIGHT}' only applies with '{CONF_CACHE_ENABLED}: false'"
+                )
             _LOGGER.info(f"SD card image configured: {file_path}")
             return value
             
@@ -522,6 +773,19 @@ IMAGE_ID_SCHEMA = {
     cv.Required(CONF_ID): cv.declare_id(Image_),
     cv.Required(CONF_FILE): cv.Any(validate_file_shorthand, TYPED_FILE_SCHEMA),
     cv.GenerateID(CONF_RAW_DATA_ID): cv.declare_id(cg.uint8),
+    # Component reading the pixels of an sd_card/ image at runtime
+    cv.GenerateID(CONF_SD_IMAGE_ID): cv.declare_id(SdImageComponent),
+    # Automations fired when an SD card image finishes loading at runtime
+    cv.Optional(CONF_ON_LOAD_COMPLETE): automation.validate_automation(
+        {
+            cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(SdImageLoadCompleteTrigger),
+        }
+    ),
+    cv.Optional(CONF_ON_LOAD_ERROR): automation.validate_automation(
+        {
+            cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(SdImageLoadErrorTrigger),
+        }
+    ),
 }
 
 
@@ -534,6 +798,34 @@ OPTIONS_SCHEMA = {
     cv.Optional(CONF_BYTE_ORDER): cv.one_of("BIG_ENDIAN", "LITTLE_ENDIAN", upper=True),
     cv.Optional(CONF_TRANSPARENCY, default=CONF_OPAQUE): validate_transparency(),
     cv.Optional(CONF_TYPE): validate_type(IMAGE_TYPE),
+    # Storage component the sd_card/ images are read from
+    cv.Optional(CONF_STORAGE_ID): cv.use_id(StorageComponent),
+    # Keep the decoded SD card pixels in RAM (default); when off, the image is
+    # streamed from the card in row bands at each draw
+    cv.Optional(CONF_CACHE_ENABLED): cv.boolean,
+    # Load the SD card image during setup
+    cv.Optional(CONF_PRELOAD): cv.boolean,
+    # Rows read per band when an SD image is drawn in streaming mode (no cache)
+    cv.Optional(CONF_STREAM_BAND_HEIGHT): cv.int_range(min=1, max=256),
+    # Read and decode SD card images on a background task instead of the main loop
+    cv.Optional(CONF_ASYNC_LOAD): cv.boolean,
+    # Keep the current SD card image drawable until its replacement is fully loaded
+    cv.Optional(CONF_DOUBLE_BUFFER): cv.boolean,
+    # Memory region for decoded SD card pixels (AUTO: PSRAM for large buffers)
+    cv.Optional(CONF_BUFFER_PLACEMENT): cv.enum(BUFFER_PLACEMENTS, upper=True),
+    # Byte budget shared by all SD card images; least recently drawn ones are evicted.
+    # One budget for the whole device: images setting it must agree
+    cv.Optional(CONF_MEMORY_BUDGET): cv.int_range(min=0),
+    # Folder receiving sd_card/ images pre-converted to the raw layout read at runtime
+    cv.Optional(CONF_SD_EXPORT): cv.string,
+    # Per-row RLE for exported images: less to read from the card for flat artwork
+    cv.Optional(CONF_SD_COMPRESSION): cv.one_of(*SD_ASSET_COMPRESSIONS, upper=True),
+    # Row offsets stored with compressed images, so partial draws seek to the first
+    # visible row (4 bytes per row, on by default)
+    cv.Optional(CONF_SD_ROW_INDEX): cv.boolean,
+    # Export as palette indices (1, 2, 4 or 8 bits per pixel for up to this many
+    # colors): icons and flat artwork cost 2-16x less to read and to keep in RAM
+    cv.Optional(CONF_SD_PALETTE): cv.int_range(min=2, max=256),
 }
 
 OPTIONS = [key.schema for key in OPTIONS_SCHEMA]
@@ -581,7 +873,11 @@ def validate_defaults(value):
             available_options.remove(CONF_BYTE_ORDER)
         config = {
             **{key: image.get(key, defaults.get(key)) for key in available_options},
-            **{key.schema: image[key.schema] for key in IMAGE_ID_SCHEMA},
+            **{
+                key.schema: image[key.schema]
+                for key in IMAGE_ID_SCHEMA
+                if key.schema in image
+            },
         }
         validate_settings(config)
         result.append(config)
@@ -659,6 +955,351 @@ def _config_schema(config):
 CONFIG_SCHEMA = _config_schema
 
 
+def _image_configs(config):
+    """
+    Yield every single image configuration, whatever the layout of the config
+    """
+    if isinstance(config, list):
+        for entry in config:
+            yield from _image_configs(entry)
+    elif CONF_ID not in config:
+        for entry in config.values():
+            yield from _image_configs(entry)
+    else:
+        yield config
+
+
+def _final_validate(config):
+    budgets = {
+        image[CONF_MEMORY_BUDGET]
+        for image in _image_configs(config)
+        if image.get(CONF_MEMORY_BUDGET) is not None
+    }
+    if len(budgets) > 1:
+        raise cv.Invalid(
+            f"'{CONF_MEMORY_BUDGET}' is shared by all SD card images, "
+            f"conflicting values: {', '.join(str(b) for b in sorted(budgets))}"
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
+
+
+def _encoded_cache_dir() -> Path:
+    path = external_files.compute_local_file_dir(DOMAIN) / "encoded"
+    path.mkdir(parents=True, exist_ok=True)
+    return path
+
+
+def _encoded_cache_key(path: Path, config, all_frames) -> str:
+    """
+    Hash of the source content and of every option that changes the encoded bytes
+    """
+    h = hashlib.sha256()
+    h.update(path.read_bytes())
+    options = (
+        ENCODED_CACHE_VERSION,
+        config[CONF_TYPE],
+        config[CONF_TRANSPARENCY],
+        config.get(CONF_RESIZE),
+        config[CONF_DITHER],
+        config.get(CONF_BYTE_ORDER),
+        config[CONF_INVERT_ALPHA],
+        all_frames,
+    )
+    h.update(repr(options).encode())
+    return h.hexdigest()
+
+
+def _read_encoded_cache(key):
+    base = _encoded_cache_dir()
+    try:
+        meta = json.loads((base / f"{key}.json").read_text())
+        data = (base / f"{key}.bin").read_bytes()
+    except (OSError, ValueError):
+        return None
+    if len(data) != meta.get("size"):
+        return None
+    return meta, data
+
+
+def _write_encoded_cache(key, meta, data):
+    base = _encoded_cache_dir()
+    try:
+        (base / f"{key}.bin").write_bytes(data)
+        # Metadata last: an interrupted write leaves no valid entry
+        (base / f"{key}.json").write_text(json.dumps({**meta, "size": len(data)}))
+    except OSError as err:
+        _LOGGER.warning("Could not write encoded image cache: %s", err)
+
+
+def _count_cache(key):
+    data = CORE.data.setdefault(DOMAIN, {})
+    data[key] = data.get(key, 0) + 1
+
+
+@coroutine_with_priority(-1000.0)
+async def _log_build_report():
+    data = CORE.data.get(DOMAIN, {})
+    hits = data.get(KEY_CACHE_HITS, 0)
+    misses = data.get(KEY_CACHE_MISSES, 0)
+    if hits or misses:
+        _LOGGER.info(
+            "Encoded image cache: %d hits, %d misses (%.0f%% reused)",
+            hits,
+            misses,
+            100.0 * hits / (hits + misses),
+        )
+    if flash_saved := data.get(KEY_SD_FLASH_SAVED):
+        _LOGGER.info("Runtime SD images: %d bytes of flash saved", flash_saved)
+    if exported := data.get(KEY_SD_EXPORT_BYTES):
+        stored = data.get(KEY_SD_EXPORT_STORED, exported)
+        _LOGGER.info(
+            "Exported SD images: %d bytes of pixels stored in %d bytes (%.0f%% less to read)",
+            exported,
+            stored,
+            100.0 * (exported - stored) / exported,
+        )
+
+
+def _fit_size(width, height, resize):
+    """
+    Scale down to fit within resize, preserving the aspect ratio
+    """
+    if not resize:
+        return width, height
+    new_width_max = min(width, resize[0])
+    new_height_max = min(height, resize[1])
+    ratio = min(new_width_max / width, new_height_max / height)
+    return int(width * ratio), int(height * ratio)
+
+
+def _encoded_size(type, width, height, transparency):
+    """
+    Size of the pixel array the encoder of an image type would emit
+    """
+    if type == "BINARY":
+        return (width + 7) // 8 * height
+    bytes_per_pixel = {"GRAYSCALE": 1, "RGB565": 2, "RGB": 3}[type]
+    # Grayscale keeps its alpha in the gray level itself
+    if transparency == CONF_ALPHA_CHANNEL and type != "GRAYSCALE":
+        bytes_per_pixel += 1
+    return width * height * bytes_per_pixel
+
+
+def _sd_export_format(type, transparency):
+    """
+    Raw format read by SdImageComponent for an image type, and the encoder producing it.
+    RGB565 with an alpha channel has no raw equivalent on the device: exported as RGBA.
+    """
+    if type in ("GRAYSCALE", "BINARY"):
+        return type, type
+    if transparency == CONF_ALPHA_CHANNEL:
+        return "RGBA", "RGB"
+    if type == "RGB565":
+        return "RGB565", "RGB565"
+    return "RGB888", "RGB"
+
+
+def encode_rle_rows(data, row_stride, height, unit):
+    """
+    Compress each row independently, in units of one pixel (one byte for binary),
+    as decoded by RleRowDecoder (rle_stream.h): a control byte c < 128 is followed
+    by c + 1 literal pixels, c >= 128 by one pixel repeated c - 126 times
+    :return: compressed rows, and the offset of each row within them
+    """
+    out = bytearray()
+    offsets = []
+    for y in range(height):
+        offsets.append(len(out))
+        row = data[y * row_stride : (y + 1) * row_stride]
+        pixels = [bytes(row[i : i + unit]) for i in range(0, len(row), unit)]
+        literals = []
+
+        def flush():
+            if literals:
+                out.append(len(literals) - 1)
+                out.extend(b"".join(literals))
+                literals.clear()
+
+        i = 0
+        while i < len(pixels):
+            run = 1
+            while i + run < len(pixels) and run < 129 and pixels[i + run] == pixels[i]:
+                run += 1
+            if run >= 2:
+                flush()
+                out.append(126 + run)
+                out.extend(pixels[i])
+            else:
+                literals.append(pixels[i])
+                if len(literals) == 128:
+                    flush()
+            i += run
+        flush()
+    return out, offsets
+
+
+def pack_sd_asset(
+    raw_format,
+    width,
+    height,
+    row_stride,
+    transparency,
+    payload,
+    compression="NONE",
+    row_index=True,
+    palette=(),
+    index_bits=0,
+):
+    """
+    Wrap encoded pixels in the SD image container, so that the device needs no
+    configuration to load them. The CRC covers the decoded pixels; compressed
+    images get a row index between the header and the pixels unless disabled.
+    INDEXED images carry their RGBA palette after the row index.
+    """
+    crc = zlib.crc32(payload)
+    flags = SD_ASSET_FLAG_CRC
+    index = b""
+    if compression == "RLE":
+        unit = 1 if raw_format in ("BINARY", "INDEXED") else row_stride // width
+        payload, offsets = encode_rle_rows(payload, row_stride, height, unit)
+        if row_index:
+            flags |= SD_ASSET_FLAG_ROW_INDEX
+            index = struct.pack(f"<{height}I", *offsets)
+    index_offset = SD_ASSET_HEADER_SIZE if index else 0
+    palette_offset = SD_ASSET_HEADER_SIZE + len(index) if palette else 0
+    colors = b"".join(bytes(entry) for entry in palette)
+    payload_offset = (
+        -(-(SD_ASSET_HEADER_SIZE + len(index) + len(colors)) // SD_ASSET_ALIGNMENT)
+        * SD_ASSET_ALIGNMENT
+    )
+    header = struct.pack(
+        "<4sHHHHBBBBIIIIBBHII",
+        SD_ASSET_MAGIC,
+        SD_ASSET_VERSION,
+        SD_ASSET_HEADER_SIZE,
+        width,
+        height,
+        SD_ASSET_FORMATS[raw_format],
+        0,  # little-endian
+        SD_ASSET_ALPHA_MODES[transparency],
+        flags,
+        row_stride,
+        payload_offset,
+        len(payload),
+        crc,
+        SD_ASSET_COMPRESSIONS[compression],
+        index_bits,
+        len(palette),
+        index_offset,
+        palette_offset,
+    )
+    return (header.ljust(SD_ASSET_HEADER_SIZE, b"\0") + index + colors).ljust(
+        payload_offset, b"\0"
+    ) + bytes(payload)
+
+
+def sd_device_path(sd_path) -> str:
+    """
+    Path of an sd_card/ image on the device, from the root of the card: absolute,
+    as SdImageComponent::validate_file_path() requires
+    """
+    relative = PurePosixPath(str(sd_path).replace("sd_card//", "sd_card/")).relative_to(
+        "sd_card"
+    )
+    return f"/{relative}"
+
+
+def export_sd_image(config, source: Path, sd_path: str):
+    """
+    Convert an sd_card/ image found in the project directory into the raw layout
+    SdImageComponent reads (RGB565 little-endian, or palette indices with sd_palette),
+    wrapped in the SD image container, and write it under the sd_export folder,
+    ready to be copied onto the card.
+    :return: width, height, transparency and runtime path of the exported file
+    """
+    image = Image.open(source)
+    width, height = _fit_size(*image.size, config.get(CONF_RESIZE))
+    raw_format, encoder_type = _sd_export_format(
+        config[CONF_TYPE], config[CONF_TRANSPARENCY]
+    )
+    dither = (
+        Image.Dither.NONE
+        if config[CONF_DITHER] == "NONE"
+        else Image.Dither.FLOYDSTEINBERG
+    )
+    if CONF_SD_PALETTE in config:
+        raw_format = "INDEXED"
+        encoder = ImageIndexed(
+            width,
+            height,
+            config[CONF_TRANSPARENCY],
+            dither,
+            config[CONF_INVERT_ALPHA],
+            config[CONF_SD_PALETTE],
+        )
+    else:
+        encoder = IMAGE_TYPE[encoder_type](
+            width, height, config[CONF_TRANSPARENCY], dither, config[CONF_INVERT_ALPHA]
+        )
+    if isinstance(encoder, ImageRGB565):
+        encoder.set_big_endian(False)
+    encoder.encode_frame(encoder.convert(image.resize((width, height)), source))
+
+    relative = PurePosixPath(sd_device_path(sd_path)[1:]).with_suffix(".sdi")
+    target = Path(CORE.relative_config_path(config[CONF_SD_EXPORT])) / relative
+    target.parent.mkdir(parents=True, exist_ok=True)
+    compression = config.get(CONF_SD_COMPRESSION, "NONE")
+    palette = getattr(encoder, "palette", ())
+    index_bits = getattr(encoder, "bits", 0)
+    asset = pack_sd_asset(
+        raw_format,
+        width,
+        height,
+        encoder.width,
+        encoder.transparency,
+        encoder.data,
+        compression,
+        config.get(CONF_SD_ROW_INDEX, True),
+        palette,
+        index_bits,
+    )
+    payload_size = struct.unpack_from("<I", asset, 24)[0]
+    if compression != "NONE" and payload_size >= len(encoder.data):
+        # No flat areas to gain from: stored as is, read without decoding
+        compression = "NONE"
+        asset = pack_sd_asset(
+            raw_format,
+            width,
+            height,
+            encoder.width,
+            encoder.transparency,
+            encoder.data,
+            palette=palette,
+            index_bits=index_bits,
+        )
+        payload_size = len(encoder.data)
+    target.write_bytes(asset)
+
+    data = CORE.data.setdefault(DOMAIN, {})
+    data[KEY_SD_EXPORT_BYTES] = data.get(KEY_SD_EXPORT_BYTES, 0) + len(encoder.data)
+    data[KEY_SD_EXPORT_STORED] = data.get(KEY_SD_EXPORT_STORED, 0) + payload_size
+    _LOGGER.info(
+        "Exported %s as %s %dx%d SD image (%s, %d of %d bytes): %s",
+        source,
+        raw_format,
+        width,
+        height,
+        compression,
+        payload_size,
+        len(encoder.data),
+        target,
+    )
+    return width, height, encoder.transparency, f"/{relative}"
+
 
 async def write_image(config, all_frames=False):
     path_str = config[CONF_FILE]
@@ -666,7 +1307,8 @@ async def write_image(config, all_frames=False):
     # Gestion spéciale pour les images SD card:
     # - si le fichier existe DANS le dossier de config au build, on le traite normalement
     # - si le fichier n'existe pas au build (c'est la plupart des cas pour sd_card/...),
-    #   on génère un placeholder (tableau d'octets à 0) ET on renvoie sd_runtime=True + sd_path
+    #   aucun tableau de pixels n'est émis (le C++ alloue au chargement) et on renvoie
+    #   sd_runtime=True + sd_path
     if isinstance(path_str, str) and (path_str.startswith("sd_card/") or path_str.startswith("sd_card//")):
         _LOGGER.info(f"Processing SD card image: {path_str}")
         # try to resolve local copy in project dir (if user put sd_card/... into the repo)
@@ -675,6 +1317,24 @@ async def write_image(config, all_frames=False):
         except Exception:
             resolved = Path(CORE.relative_config_path(path_str.replace("sd_card//", "sd_card/")))
 
+        if resolved.is_file() and CONF_SD_EXPORT in config and not is_svg_file(resolved):
+            # Converted now into the raw layout read by the device, which then
+            # loads it at runtime without decoding nor byte swapping; its header
+            # describes the pixels, so nothing else is configured
+            width, height, transparency, sd_path = export_sd_image(
+                config, resolved, path_str
+            )
+            return (
+                cg.nullptr,
+                width,
+                height,
+                get_image_type_enum(config[CONF_TYPE]),
+                get_transparency_enum(transparency),
+                1,
+                True,
+                sd_path,
+            )
+
         if resolved.is_file():
             _LOGGER.info(f"Found SD image in project dir; will process at build-time: {resolved}")
             # fall through to normal local-file processing by assigning path = resolved
@@ -684,36 +1344,41 @@ async def write_image(config, all_frames=False):
         else:
             # --- runtime SD mode: do NOT attempt to open the SD file at build ---
             sd_runtime = True
-            sd_path = path_str
-            # Dimensions: use resize if provided, otherwise default small size
+            sd_path = sd_device_path(path_str)
+            # Dimensions: use resize if provided, otherwise 0x0 and the component
+            # reads the real size from the JPEG/PNG header when the image is loaded
             resize = config.get(CONF_RESIZE)
             if resize:
                 width, height = resize
             else:
-                width, height = 64, 64
-                _LOGGER.warning(f"No resize specified for SD card image {path_str}, using default size {width}x{height}")
+                width, height = 0, 0
+                _LOGGER.info(f"No resize specified for SD card image {path_str}, size will be probed at runtime")
 
-            dither = (
-                Image.Dither.NONE
-                if config[CONF_DITHER] == "NONE"
-                else Image.Dither.FLOYDSTEINBERG
-            )
             type = config[CONF_TYPE]
             transparency = config[CONF_TRANSPARENCY]
-            invert_alpha = config[CONF_INVERT_ALPHA]
             frame_count = 1
 
-            # Create encoder and leave data as zeros (placeholder).
-            encoder = IMAGE_TYPE[type](width, height, transparency, dither, invert_alpha)
-            if byte_order := config.get(CONF_BYTE_ORDER):
-                encoder.set_big_endian(byte_order == "BIG_ENDIAN")
-
-            rhs = [HexInt(x) for x in encoder.data]
-            prog_arr = cg.progmem_array(config[CONF_RAW_DATA_ID], rhs)
+            # No pixel array is emitted: the pixels are allocated by the C++ side
+            # when the image is loaded, so no flash is spent on a zero-filled
+            # placeholder. Its size is only known when the dimensions are.
+            prog_arr = cg.nullptr
             image_type = get_image_type_enum(type)
-            trans_value = get_transparency_enum(encoder.transparency)
-
-            _LOGGER.info(f"SD card image configured for runtime load: {sd_path} - placeholder {width}x{height}")
+            trans_value = get_transparency_enum(transparency)
+
+            if width > 0 and height > 0:
+                flash_saved = _encoded_size(type, width, height, transparency)
+                total_saved = CORE.data.setdefault(DOMAIN, {}).get(KEY_SD_FLASH_SAVED, 0) + flash_saved
+                CORE.data[DOMAIN][KEY_SD_FLASH_SAVED] = total_saved
+                _LOGGER.info(
+                    "SD card image configured for runtime load: %s (%dx%d), %d bytes of flash saved (%d in total)",
+                    sd_path,
+                    width,
+                    height,
+                    flash_saved,
+                    total_saved,
+                )
+            else:
+                _LOGGER.info("SD card image configured for runtime load: %s", sd_path)
             return prog_arr, width, height, image_type, trans_value, frame_count, sd_runtime, sd_path
 
     else:
@@ -725,6 +1390,26 @@ async def write_image(config, all_frames=False):
     if not path.is_file():
         raise core.EsphomeError(f"Could not load image file {path}")
 
+    type = config[CONF_TYPE]
+    cache_key = _encoded_cache_key(path, config, all_frames)
+    if (cached := _read_encoded_cache(cache_key)) is not None:
+        # Unchanged source and options: reuse the encoded bytes, PIL is never involved
+        meta, data = cached
+        _count_cache(KEY_CACHE_HITS)
+        rhs = [HexInt(x) for x in data]
+        prog_arr = cg.progmem_array(config[CONF_RAW_DATA_ID], rhs)
+        return (
+            prog_arr,
+            meta["width"],
+            meta["height"],
+            get_image_type_enum(type),
+            get_transparency_enum(meta["transparency"]),
+            meta["frame_count"],
+            sd_runtime,
+            sd_path,
+        )
+    _count_cache(KEY_CACHE_MISSES)
+
     resize = config.get(CONF_RESIZE)
     if is_svg_file(path):
         # Local import so use of non-SVG files needn't require cairosvg installed
@@ -742,13 +1427,8 @@ async def write_image(config, all_frames=False):
         width, height = image.size
     else:
         image = Image.open(path)
-        width, height = image.size
-        if resize:
-            # Preserve aspect ratio
-            new_width_max = min(width, resize[0])
-            new_height_max = min(height, resize[1])
-            ratio = min(new_width_max / width, new_height_max / height)
-            width, height = int(width * ratio), int(height * ratio)
+        # Preserve aspect ratio
+        width, height = _fit_size(*image.size, resize)
 
     if not resize and (width > 500 or height > 500):
         _LOGGER.warning(
@@ -762,7 +1442,6 @@ async def write_image(config, all_frames=False):
         if config[CONF_DITHER] == "NONE"
         else Image.Dither.FLOYDSTEINBERG
     )
-    type = config[CONF_TYPE]
     transparency = config[CONF_TRANSPARENCY]
     invert_alpha = config[CONF_INVERT_ALPHA]
     frame_count = 1
@@ -781,11 +1460,18 @@ async def write_image(config, all_frames=False):
         encoder.set_big_endian(byte_order == "BIG_ENDIAN")
     for frame_index in range(frame_count):
         image.seek(frame_index)
-        pixels = encoder.convert(image.resize((width, height)), path).getdata()
-        for row in range(height):
-            for col in range(width):
-                encoder.encode(pixels[row * width + col])
-            encoder.end_row()
+        encoder.encode_frame(encoder.convert(image.resize((width, height)), path))
+
+    _write_encoded_cache(
+        cache_key,
+        {
+            "width": width,
+            "height": height,
+            "frame_count": frame_count,
+            "transparency": encoder.transparency,
+        },
+        bytes(encoder.data),
+    )
 
     rhs = [HexInt(x) for x in encoder.data]
     prog_arr = cg.progmem_array(config[CONF_RAW_DATA_ID], rhs)
@@ -796,6 +1482,10 @@ async def write_image(config, all_frames=False):
 
 
 async def to_code(config):
+    data = CORE.data.setdefault(DOMAIN, {})
+    if not data.get(KEY_REPORT_SCHEDULED):
+        data[KEY_REPORT_SCHEDULED] = True
+        CORE.add_job(_log_build_report)
     if isinstance(config, list):
         for entry in config:
             await to_code(entry)
@@ -804,16 +1494,84 @@ async def to_code(config):
             await to_code(entry)
     else:
         prog_arr, width, height, image_type, trans_value, _, sd_runtime, sd_path = await write_image(config)
-        var = cg.new_Pvariable(config[CONF_ID], prog_arr, width, height, image_type, trans_value)
-
-        # Si image configurée pour lecture runtime depuis la SD -> transmettre le chemin au C++
+        # Image lue depuis la SD: sans données, l'Image est déclarée en 0x0 pour
+        # qu'un draw() sur elle ne lise rien; l'affichage passe par le
+        # SdImageComponent (sd_image_id)
+        image_width, image_height = (0, 0) if sd_runtime else (width, height)
+        var = cg.new_Pvariable(config[CONF_ID], prog_arr, image_width, image_height, image_type, trans_value)
+
+        # Si image configurée pour lecture runtime depuis la SD -> les pixels
+        # sont lus par un SdImageComponent
         if sd_runtime:
-            # Ces setters doivent être implémentés dans ta classe C++ Image:
-            #   void set_sd_path(const std::string &path);
-            #   void set_sd_runtime(bool enabled);
-            cg.add(var.set_sd_path(sd_path))
-            cg.add(var.set_sd_runtime(True))
+            sd_var = cg.new_Pvariable(config[CONF_SD_IMAGE_ID])
+            await cg.register_component(sd_var, config)
+            storage = await cg.get_variable(config[CONF_STORAGE_ID])
+            cg.add(sd_var.set_storage_component(storage))
+            cg.add(sd_var.set_file_path(sd_path))
+            raw_format, _ = _sd_export_format(config[CONF_TYPE], config[CONF_TRANSPARENCY])
+            cg.add(sd_var.set_format_string(raw_format))
+            if raw_format in ("RGB565", "RGB888", "RGBA"):
+                cg.add(sd_var.set_output_format_string(raw_format))
+            if (byte_order := config.get(CONF_BYTE_ORDER)) is not None:
+                cg.add(sd_var.set_byte_order_string(byte_order))
+            if width > 0 and height > 0:
+                cg.add(sd_var.set_width(width))
+                cg.add(sd_var.set_height(height))
+            if (cache_enabled := config.get(CONF_CACHE_ENABLED)) is not None:
+                cg.add(sd_var.set_cache_enabled(cache_enabled))
+            if config.get(CONF_PRELOAD):
+                cg.add(sd_var.set_preload(True))
+            if (band_height := config.get(CONF_STREAM_BAND_HEIGHT)) is not None:
+                cg.add(sd_var.set_stream_band_height(band_height))
+            if config.get(CONF_ASYNC_LOAD):
+                cg.add(sd_var.set_async_load(True))
+            if config.get(CONF_DOUBLE_BUFFER):
+                cg.add(sd_var.set_double_buffer(True))
+            if (placement := config.get(CONF_BUFFER_PLACEMENT)) is not None:
+                cg.add(sd_var.set_buffer_placement(placement))
+            budget = config.get(CONF_MEMORY_BUDGET)
+            if budget is not None and not data.get(KEY_MEMORY_BUDGET_SET):
+                data[KEY_MEMORY_BUDGET_SET] = True
+                cg.add(sd_var.set_memory_budget(budget))
+            for conf in config.get(CONF_ON_LOAD_COMPLETE, []):
+                trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], sd_var)
+                await automation.build_automation(trigger, [], conf)
+            for conf in config.get(CONF_ON_LOAD_ERROR, []):
+                trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], sd_var)
+                await automation.build_automation(trigger, [], conf)
 
         # (on garde le comportement original de création de la variable)
 
 
+@automation.register_action(
+    "sd_image.load",
+    SdImageLoadAction,
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.use_id(SdImageComponent),
+            # Another file than the configured one, e.g. for a slideshow
+            cv.Optional(CONF_FILE_PATH): cv.templatable(cv.string),
+        }
+    ),
+)
+async def sd_image_load_to_code(config, action_id, template_arg, args):
+    parent = await cg.get_variable(config[CONF_ID])
+    var = cg.new_Pvariable(action_id, template_arg, parent)
+    if (file_path := config.get(CONF_FILE_PATH)) is not None:
+        template_ = await cg.templatable(file_path, args, cg.std_string)
+        cg.add(var.set_file_path(template_))
+    return var
+
+
+@automation.register_action(
+    "sd_image.unload",
+    SdImageUnloadAction,
+    automation.maybe_simple_id(
+        {
+            cv.GenerateID(): cv.use_id(SdImageComponent),
+        }
+    ),
+)
+async def sd_image_unload_to_code(config, action_id, template_arg, args):
+    parent = await cg.get_variable(config[CONF_ID])
+    return cg.new_Pvariable(action_id, template_arg, parent)
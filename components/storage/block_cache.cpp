@@ -0,0 +1,161 @@
+#include "block_cache.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+#include <new>
+
+namespace esphome {
+namespace storage {
+
+static const char *const TAG = "storage.cache";
+
+void BlockCache::init(size_t capacity) {
+  this->index_.clear();
+  this->pool_.reset();
+  this->entries_.clear();
+  this->head_ = NONE;
+  this->tail_ = NONE;
+
+  size_t count = capacity / BLOCK_SIZE;
+  if (count == 0) {
+    return;
+  }
+
+  this->pool_.reset(new (std::nothrow) uint8_t[count * BLOCK_SIZE]);
+  if (!this->pool_) {
+    ESP_LOGE(TAG, "Failed to allocate %zu bytes for the block cache", count * BLOCK_SIZE);
+    return;
+  }
+
+  this->entries_.resize(count);
+  this->index_.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    this->push_back(static_cast<int32_t>(i));
+  }
+}
+
+const uint8_t *BlockCache::lookup(uint32_t file_id, uint32_t block, size_t &length) {
+  auto it = this->index_.find(make_key(file_id, block));
+  if (it == this->index_.end()) {
+    return nullptr;
+  }
+
+  this->hits_++;
+  int32_t index = it->second;
+  if (index != this->head_) {
+    this->unlink(index);
+    this->push_front(index);
+  }
+  length = this->entries_[index].length;
+  return &this->pool_[static_cast<size_t>(index) * BLOCK_SIZE];
+}
+
+void BlockCache::insert(uint32_t file_id, uint32_t block, const uint8_t *data, size_t length) {
+  if (this->entries_.empty() || length == 0 || length > BLOCK_SIZE) {
+    return;
+  }
+
+  uint64_t key = make_key(file_id, block);
+  int32_t index;
+  auto it = this->index_.find(key);
+  if (it != this->index_.end()) {
+    index = it->second;
+  } else {
+    // Réutiliser la queue: un bloc libre s'il en reste, sinon le moins récent
+    index = this->tail_;
+    Entry &victim = this->entries_[index];
+    if (victim.used) {
+      this->index_.erase(victim.key);
+      this->evictions_++;
+    }
+    victim.key = key;
+    victim.used = true;
+    this->index_[key] = index;
+    this->misses_++;
+  }
+
+  this->entries_[index].length = static_cast<uint16_t>(length);
+  memcpy(&this->pool_[static_cast<size_t>(index) * BLOCK_SIZE], data, length);
+  if (index != this->head_) {
+    this->unlink(index);
+    this->push_front(index);
+  }
+}
+
+bool BlockCache::contains(uint32_t file_id, uint32_t block) const {
+  return this->index_.count(make_key(file_id, block)) != 0;
+}
+
+void BlockCache::invalidate(uint32_t file_id) {
+  for (size_t i = 0; i < this->entries_.size(); i++) {
+    Entry &entry = this->entries_[i];
+    if (entry.used && (entry.key >> 32) == file_id) {
+      this->index_.erase(entry.key);
+      entry.used = false;
+      this->unlink(static_cast<int32_t>(i));
+      this->push_back(static_cast<int32_t>(i));
+    }
+  }
+}
+
+void BlockCache::clear() {
+  // Tous les blocs redeviennent libres, rangés en queue pour être réutilisés
+  this->index_.clear();
+  this->head_ = NONE;
+  this->tail_ = NONE;
+  for (size_t i = 0; i < this->entries_.size(); i++) {
+    this->entries_[i].used = false;
+    this->push_back(static_cast<int32_t>(i));
+  }
+}
+
+void BlockCache::reset_stats() {
+  this->hits_ = 0;
+  this->misses_ = 0;
+  this->evictions_ = 0;
+}
+
+void BlockCache::unlink(int32_t index) {
+  Entry &entry = this->entries_[index];
+  if (entry.prev != NONE) {
+    this->entries_[entry.prev].next = entry.next;
+  } else {
+    this->head_ = entry.next;
+  }
+  if (entry.next != NONE) {
+    this->entries_[entry.next].prev = entry.prev;
+  } else {
+    this->tail_ = entry.prev;
+  }
+  entry.prev = NONE;
+  entry.next = NONE;
+}
+
+void BlockCache::push_front(int32_t index) {
+  Entry &entry = this->entries_[index];
+  entry.prev = NONE;
+  entry.next = this->head_;
+  if (this->head_ != NONE) {
+    this->entries_[this->head_].prev = index;
+  }
+  this->head_ = index;
+  if (this->tail_ == NONE) {
+    this->tail_ = index;
+  }
+}
+
+void BlockCache::push_back(int32_t index) {
+  Entry &entry = this->entries_[index];
+  entry.next = NONE;
+  entry.prev = this->tail_;
+  if (this->tail_ != NONE) {
+    this->entries_[this->tail_].next = index;
+  }
+  this->tail_ = index;
+  if (this->head_ == NONE) {
+    this->head_ = index;
+  }
+}
+
+}  // namespace storage
+}  // namespace esphome
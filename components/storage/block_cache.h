@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace esphome {
+namespace storage {
+
+// Cache de blocs de fichiers en RAM, éviction LRU. Les blocs sont alloués
+// une seule fois dans un pool de taille fixe; la liste LRU est chaînée par
+// indices, donc aucune allocation n'a lieu pendant les lectures.
+class BlockCache {
+ public:
+  // Un secteur FAT: aligne les lectures SD sur le cache
+  static const size_t BLOCK_SIZE = 512;
+
+  // Alloue le pool (capacity / BLOCK_SIZE blocs); 0 désactive le cache
+  void init(size_t capacity);
+  bool is_enabled() const { return !this->entries_.empty(); }
+  size_t get_block_count() const { return this->entries_.size(); }
+  size_t get_capacity() const { return this->entries_.size() * BLOCK_SIZE; }
+
+  // Renvoie le bloc et sa longueur utile (le dernier bloc d'un fichier est
+  // court), ou nullptr si absent. Un bloc trouvé compte comme un hit.
+  const uint8_t *lookup(uint32_t file_id, uint32_t block, size_t &length);
+  bool contains(uint32_t file_id, uint32_t block) const;
+  // Copie le bloc dans le cache en évinçant le moins récemment utilisé.
+  // Chaque nouveau bloc a été lu sur la SD et compte comme un miss.
+  void insert(uint32_t file_id, uint32_t block, const uint8_t *data, size_t length);
+  // Retire tous les blocs d'un fichier (après une écriture)
+  void invalidate(uint32_t file_id);
+  void clear();
+
+  uint32_t get_hits() const { return this->hits_; }
+  uint32_t get_misses() const { return this->misses_; }
+  uint32_t get_evictions() const { return this->evictions_; }
+  void reset_stats();
+
+ protected:
+  static const int32_t NONE = -1;
+
+  struct Entry {
+    uint64_t key{0};
+    uint16_t length{0};
+    bool used{false};
+    int32_t prev{NONE};
+    int32_t next{NONE};
+  };
+
+  static uint64_t make_key(uint32_t file_id, uint32_t block) { return (uint64_t(file_id) << 32) | block; }
+  void unlink(int32_t index);
+  void push_front(int32_t index);
+  void push_back(int32_t index);
+
+  std::unique_ptr<uint8_t[]> pool_;
+  std::vector<Entry> entries_;
+  std::unordered_map<uint64_t, int32_t> index_;
+  // Tête = plus récemment utilisé, queue = prochain évincé (les blocs libres y sont rangés)
+  int32_t head_{NONE};
+  int32_t tail_{NONE};
+
+  uint32_t hits_{0};
+  uint32_t misses_{0};
+  uint32_t evictions_{0};
+};
+
+}  // namespace storage
+}  // namespace esphome
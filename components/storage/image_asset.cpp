@@ -0,0 +1,165 @@
+#include "image_asset.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+
+#ifdef USE_ESP32
+#include <esp_rom_crc.h>
+#endif
+
+namespace esphome {
+namespace storage {
+
+static const char *const TAG = "storage.asset";
+
+static const uint8_t ASSET_MAGIC[4] = {'S', 'D', 'I', 'M'};
+
+static uint16_t read_u16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t read_u32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool ImageAssetHeader::has_magic(const uint8_t *data, size_t size) {
+  return size >= sizeof(ASSET_MAGIC) && memcmp(data, ASSET_MAGIC, sizeof(ASSET_MAGIC)) == 0;
+}
+
+bool ImageAssetHeader::parse(const uint8_t *data, size_t size) {
+  if (size < SIZE || !has_magic(data, size)) {
+    return false;
+  }
+
+  this->version = read_u16(data + 4);
+  if (this->version == 0 || this->version > VERSION) {
+    ESP_LOGE(TAG, "Unsupported image container version %u", this->version);
+    return false;
+  }
+  size_t header_size = read_u16(data + 6);
+  this->width = read_u16(data + 8);
+  this->height = read_u16(data + 10);
+
+  // Codes du format: SD_ASSET_FORMATS dans __init__.py
+  switch (data[12]) {
+    case 0:
+      this->format = ImageFormat::rgb565;
+      break;
+    case 1:
+      this->format = ImageFormat::rgb888;
+      break;
+    case 2:
+      this->format = ImageFormat::rgba;
+      break;
+    case 3:
+      this->format = ImageFormat::grayscale;
+      break;
+    case 4:
+      this->format = ImageFormat::binary;
+      break;
+    case 5:
+      this->format = ImageFormat::indexed;
+      break;
+    default:
+      ESP_LOGE(TAG, "Unknown pixel format code %u", data[12]);
+      return false;
+  }
+  if (data[13] > 1 || data[14] > static_cast<uint8_t>(AlphaMode::chroma_key)) {
+    ESP_LOGE(TAG, "Invalid byte order or alpha mode");
+    return false;
+  }
+  this->byte_order = data[13] == 0 ? ByteOrder::little_endian : ByteOrder::big_endian;
+  this->alpha_mode = static_cast<AlphaMode>(data[14]);
+  this->flags = data[15];
+  this->row_stride = read_u32(data + 16);
+  this->payload_offset = read_u32(data + 20);
+  this->payload_size = read_u32(data + 24);
+  this->crc32 = read_u32(data + 28);
+  this->compression = PayloadCompression::none;
+  if (this->version >= 2 && header_size > 32) {
+    if (data[32] > static_cast<uint8_t>(PayloadCompression::rle)) {
+      ESP_LOGE(TAG, "Unknown compression %u", data[32]);
+      return false;
+    }
+    this->compression = static_cast<PayloadCompression>(data[32]);
+  }
+  this->row_index_offset = 0;
+  if (this->has_row_index()) {
+    this->row_index_offset = read_u32(data + 36);
+    if (this->version < 2 || header_size < 40 || this->row_index_offset < header_size ||
+        this->row_index_offset + 4 * static_cast<size_t>(this->height) > this->payload_offset) {
+      ESP_LOGE(TAG, "Invalid row index at offset %zu", this->row_index_offset);
+      return false;
+    }
+  }
+  this->index_bits = 0;
+  this->palette_size = 0;
+  this->palette_offset = 0;
+  if (this->has_palette()) {
+    this->index_bits = data[33];
+    this->palette_size = read_u16(data + 34);
+    this->palette_offset = read_u32(data + 40);
+    bool bits_ok = this->index_bits == 1 || this->index_bits == 2 || this->index_bits == 4 || this->index_bits == 8;
+    if (this->version < 2 || header_size < 44 || !bits_ok || this->palette_size == 0 ||
+        this->palette_size > (1u << this->index_bits) || this->palette_offset < header_size ||
+        this->palette_offset + 4 * this->palette_size > this->payload_offset) {
+      ESP_LOGE(TAG, "Invalid palette (%u bits, %zu colors at offset %zu)", this->index_bits, this->palette_size,
+               this->palette_offset);
+      return false;
+    }
+  }
+
+  // Formats d'au moins un octet par pixel: le display saute le bourrage de fin
+  // de ligne en pixels entiers (x_pad), il doit donc en être un multiple
+  if (this->format != ImageFormat::binary && this->format != ImageFormat::indexed && this->width > 0) {
+    size_t pixel_size = this->get_min_row_stride() / this->width;
+    if (this->row_stride % pixel_size != 0) {
+      ESP_LOGE(TAG, "Row stride %zu is not a whole number of %zu-byte pixels", this->row_stride, pixel_size);
+      return false;
+    }
+  }
+
+  // Compressé, seule la taille décodée est connue d'avance
+  size_t min_payload = this->is_compressed() ? 1 : this->row_stride * static_cast<size_t>(this->height);
+  if (this->width <= 0 || this->height <= 0 || header_size < 32 || this->payload_offset < header_size ||
+      this->row_stride < this->get_min_row_stride() || this->payload_size < min_payload) {
+    ESP_LOGE(TAG, "Inconsistent image container header (%dx%d, stride %zu, payload %zu bytes at %zu)",
+             this->width, this->height, this->row_stride, this->payload_size, this->payload_offset);
+    return false;
+  }
+  return true;
+}
+
+size_t ImageAssetHeader::get_min_row_stride() const {
+  switch (this->format) {
+    case ImageFormat::binary:
+      return (this->width + 7) / 8;
+    case ImageFormat::indexed:
+      return (this->width * this->index_bits + 7) / 8;
+    case ImageFormat::grayscale:
+      return this->width;
+    case ImageFormat::rgb888:
+      return this->width * 3;
+    case ImageFormat::rgba:
+      return this->width * 4;
+    case ImageFormat::rgb565:
+    default:
+      return this->width * 2;
+  }
+}
+
+uint32_t crc32_le(const uint8_t *data, size_t size) {
+#ifdef USE_ESP32
+  // Implémentation en ROM, avec table
+  return esp_rom_crc32_le(0, data, size);
+#else
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+#endif
+}
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "storage.h"
+
+namespace esphome {
+namespace storage {
+
+// Mode de transparence déclaré par l'en-tête (même sens que `transparency`
+// dans la configuration)
+enum class AlphaMode : uint8_t {
+  opaque,
+  alpha_channel,
+  chroma_key
+};
+
+// En-tête des images exportées au build (sd_export, voir __init__.py): le
+// fichier décrit lui-même ses pixels, aucune configuration n'est nécessaire
+// au chargement. Les pixels commencent à un offset aligné sur 512 octets,
+// leur lecture tombe donc sur des secteurs entiers. Champs little-endian:
+//
+//    0  magic "SDIM"            16  row_stride (u32, octets par ligne)
+//    4  version (u16)           20  payload_offset (u32)
+//    6  header_size (u16)       24  payload_size (u32)
+//    8  width (u16)             28  crc32 des pixels décodés (u32, si FLAG_CRC)
+//   10  height (u16)            32  compression (u8, version 2)
+//   12  format (u8)             33  index_bits (u8, format indexé)
+//   13  byte_order (u8, 0 = little-endian)
+//   14  alpha_mode (u8)         34  palette_size (u16, format indexé)
+//   15  flags (u8)              36  row_index_offset (u32, si FLAG_ROW_INDEX)
+//                               40  palette_offset (u32, format indexé)
+//                               44  réservé jusqu'à header_size
+//
+// Compressé, payload_size est la taille stockée; row_stride reste celle des
+// lignes décodées. L'index des lignes donne alors, pour chaque ligne, son
+// offset (u32) depuis le début du payload: un draw partiel va directement
+// à la première ligne visible au lieu de décoder toutes les précédentes.
+//
+// Format indexé: chaque pixel est un indice de index_bits bits (1, 2, 4 ou 8,
+// bit de poids fort en premier, lignes complétées à l'octet) dans une
+// palette de palette_size entrées RGBA stockée avant les pixels.
+struct ImageAssetHeader {
+  static const size_t SIZE = 64;
+  // Versions antérieures toujours lues (version 1: jamais compressé)
+  static const uint16_t VERSION = 2;
+  static const size_t PAYLOAD_ALIGNMENT = 512;
+  static const uint8_t FLAG_CRC = 0x01;
+  static const uint8_t FLAG_ROW_INDEX = 0x02;
+
+  uint16_t version{0};
+  int width{0};
+  int height{0};
+  ImageFormat format{ImageFormat::rgb565};
+  ByteOrder byte_order{ByteOrder::little_endian};
+  AlphaMode alpha_mode{AlphaMode::opaque};
+  uint8_t flags{0};
+  size_t row_stride{0};
+  size_t payload_offset{0};
+  size_t payload_size{0};
+  uint32_t crc32{0};
+  PayloadCompression compression{PayloadCompression::none};
+  size_t row_index_offset{0};
+  uint8_t index_bits{0};
+  size_t palette_size{0};
+  size_t palette_offset{0};
+
+  // Les premiers octets du fichier portent-ils la signature du conteneur ?
+  static bool has_magic(const uint8_t *data, size_t size);
+  // Décode et valide les SIZE premiers octets du fichier
+  bool parse(const uint8_t *data, size_t size);
+  bool has_crc() const { return (this->flags & FLAG_CRC) != 0; }
+  bool is_compressed() const { return this->compression != PayloadCompression::none; }
+  bool has_row_index() const { return (this->flags & FLAG_ROW_INDEX) != 0; }
+  bool has_palette() const { return this->format == ImageFormat::indexed; }
+  // Octets minimum d'une ligne pour ce format et cette largeur
+  size_t get_min_row_stride() const;
+};
+
+// CRC-32 standard (celui de zlib.crc32 côté Python)
+uint32_t crc32_le(const uint8_t *data, size_t size);
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,198 @@
+#include "image_buffer.h"
+#include "esphome/core/log.h"
+
+#include <cstdlib>
+#include <utility>
+
+#ifdef USE_ESP32
+#include <esp_heap_caps.h>
+#endif
+
+namespace esphome {
+namespace storage {
+
+static const char *const TAG = "storage.buffer";
+
+// Indexé par BufferRegion (internal, psram)
+static RegionUsage region_usage[3];
+
+static RegionUsage &usage_for(BufferRegion region) {
+  switch (region) {
+    case BufferRegion::internal:
+      return region_usage[1];
+    case BufferRegion::psram:
+      return region_usage[2];
+    default:
+      return region_usage[0];
+  }
+}
+
+const RegionUsage &ImageBuffer::get_usage(BufferRegion region) { return usage_for(region); }
+
+const char *ImageBuffer::region_to_string(BufferRegion region) {
+  switch (region) {
+    case BufferRegion::internal:
+      return "internal";
+    case BufferRegion::psram:
+      return "PSRAM";
+    case BufferRegion::external:
+      return "caller";
+    default:
+      return "none";
+  }
+}
+
+uint8_t *ImageBuffer::allocate_in(BufferRegion region, size_t size) {
+  RegionUsage &usage = usage_for(region);
+#ifdef USE_ESP32
+  uint32_t caps = region == BufferRegion::psram ? MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT
+                                                : MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA | MALLOC_CAP_8BIT;
+  auto *data = static_cast<uint8_t *>(heap_caps_malloc(size, caps));
+#else
+  // Sans ESP32, une seule région: tout compte comme RAM interne
+  if (region != BufferRegion::internal) {
+    return nullptr;
+  }
+  auto *data = static_cast<uint8_t *>(malloc(size));
+#endif
+  if (data == nullptr) {
+    usage.failures++;
+    return nullptr;
+  }
+
+  usage.allocations++;
+  size_t in_use = usage.in_use += size;
+  if (in_use > usage.peak) {
+    usage.peak = in_use;
+  }
+  return data;
+}
+
+bool ImageBuffer::allocate(size_t size) {
+  if (this->region_ == BufferRegion::external) {
+    if (size > this->capacity_) {
+      ESP_LOGE(TAG, "Caller buffer too small: %zu bytes needed, %zu available", size, this->capacity_);
+      return false;
+    }
+    this->size_ = size;
+    return true;
+  }
+
+  // Réutiliser l'allocation existante si elle a exactement la bonne taille
+  // (jamais un buffer partagé: d'autres images le lisent encore)
+  if (this->data_ != nullptr && !this->shared_ && this->capacity_ == size) {
+    this->size_ = size;
+    return true;
+  }
+
+  this->release();
+  if (size == 0) {
+    return true;
+  }
+
+  // Région préférée, puis l'autre en repli (sauf placement imposé)
+  BufferRegion first = BufferRegion::internal;
+  BufferRegion second = BufferRegion::none;
+  switch (this->placement_) {
+    case BufferPlacement::psram:
+      first = BufferRegion::psram;
+      break;
+    case BufferPlacement::internal:
+      first = BufferRegion::internal;
+      break;
+    case BufferPlacement::automatic:
+    default:
+      first = size > AUTO_PSRAM_THRESHOLD ? BufferRegion::psram : BufferRegion::internal;
+      second = first == BufferRegion::psram ? BufferRegion::internal : BufferRegion::psram;
+      break;
+  }
+
+  BufferRegion region = first;
+  this->data_ = this->allocate_in(first, size);
+  if (this->data_ == nullptr && second != BufferRegion::none) {
+    region = second;
+    this->data_ = this->allocate_in(second, size);
+  }
+  if (this->data_ == nullptr) {
+    ESP_LOGE(TAG, "Failed to allocate %zu bytes (%s)", size, region_to_string(first));
+    return false;
+  }
+
+  this->size_ = size;
+  this->capacity_ = size;
+  this->region_ = region;
+  return true;
+}
+
+void ImageBuffer::wrap(uint8_t *data, size_t capacity) {
+  this->release();
+  this->data_ = data;
+  this->capacity_ = capacity;
+  this->region_ = data != nullptr ? BufferRegion::external : BufferRegion::none;
+}
+
+void ImageBuffer::free_in(BufferRegion region, uint8_t *data, size_t capacity) {
+  usage_for(region).in_use -= capacity;
+#ifdef USE_ESP32
+  heap_caps_free(data);
+#else
+  free(data);
+#endif
+}
+
+void ImageBuffer::release() {
+  if (this->shared_) {
+    // Le dernier détenteur libère via le deleter de share()
+    this->shared_.reset();
+  } else if (this->data_ != nullptr &&
+             (this->region_ == BufferRegion::internal || this->region_ == BufferRegion::psram)) {
+    free_in(this->region_, this->data_, this->capacity_);
+  }
+  this->data_ = nullptr;
+  this->size_ = 0;
+  this->capacity_ = 0;
+  this->region_ = BufferRegion::none;
+}
+
+void ImageBuffer::swap(ImageBuffer &other) noexcept {
+  std::swap(this->data_, other.data_);
+  std::swap(this->size_, other.size_);
+  std::swap(this->capacity_, other.capacity_);
+  std::swap(this->placement_, other.placement_);
+  std::swap(this->region_, other.region_);
+  this->shared_.swap(other.shared_);
+}
+
+ImageBuffer ImageBuffer::share() {
+  ImageBuffer copy;
+  if (this->data_ == nullptr || this->region_ == BufferRegion::external) {
+    return copy;
+  }
+  if (!this->shared_) {
+    BufferRegion region = this->region_;
+    size_t capacity = this->capacity_;
+    this->shared_.reset(this->data_, [region, capacity](uint8_t *data) { free_in(region, data, capacity); });
+  }
+  copy.adopt(this->shared_, this->size_, this->region_);
+  copy.placement_ = this->placement_;
+  return copy;
+}
+
+void ImageBuffer::adopt(std::shared_ptr<uint8_t> data, size_t size, BufferRegion region) {
+  this->release();
+  this->shared_ = std::move(data);
+  this->data_ = this->shared_.get();
+  this->size_ = size;
+  this->capacity_ = size;
+  this->region_ = this->data_ != nullptr ? region : BufferRegion::none;
+}
+
+long ImageBuffer::get_share_count() const {
+  if (this->shared_) {
+    return this->shared_.use_count();
+  }
+  return this->data_ != nullptr ? 1 : 0;
+}
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+
+namespace esphome {
+namespace storage {
+
+// Où placer les pixels: automatic choisit la PSRAM pour les gros buffers et
+// garde la RAM interne (DMA) pour les petits, avec repli sur l'autre région
+enum class BufferPlacement {
+  automatic,
+  psram,
+  internal
+};
+
+// Région effectivement utilisée par une allocation
+enum class BufferRegion : uint8_t {
+  none,
+  internal,
+  psram,
+  external  // buffer fourni par l'appelant
+};
+
+// Occupation d'une région par les buffers d'images
+struct RegionUsage {
+  std::atomic<size_t> in_use{0};
+  std::atomic<size_t> peak{0};
+  std::atomic<uint32_t> allocations{0};
+  std::atomic<uint32_t> failures{0};
+};
+
+// Buffer de pixels d'une image: alloué par le composant dans la région
+// demandée, ou fourni par l'appelant (buffer préalloué, en PSRAM par exemple)
+// et alors jamais libéré ici. Les données sont écrites directement dedans par
+// la lecture SD ou les décodeurs, sans vector intermédiaire.
+class ImageBuffer {
+ public:
+  ImageBuffer() = default;
+  ~ImageBuffer() { this->release(); }
+
+  ImageBuffer(const ImageBuffer &) = delete;
+  ImageBuffer &operator=(const ImageBuffer &) = delete;
+  ImageBuffer(ImageBuffer &&other) noexcept { this->swap(other); }
+  ImageBuffer &operator=(ImageBuffer &&other) noexcept {
+    if (this != &other) {
+      this->release();
+      this->swap(other);
+    }
+    return *this;
+  }
+
+  // Prépare `size` octets. Un buffer externe est réutilisé s'il est assez
+  // grand; sinon échec, il n'est jamais remplacé par une allocation.
+  bool allocate(size_t size);
+  // Utilise le buffer de l'appelant (capacité `capacity`), vide au départ
+  void wrap(uint8_t *data, size_t capacity);
+  // Région demandée pour les prochaines allocations
+  void set_placement(BufferPlacement placement) { this->placement_ = placement; }
+  void release();
+  void swap(ImageBuffer &other) noexcept;
+
+  // Partage avec compteur de références: le buffer devient commun à toutes
+  // les copies et n'est libéré qu'avec la dernière. Un buffer externe ne se
+  // partage pas (renvoie un buffer vide).
+  ImageBuffer share();
+  // Reprend un buffer partagé encore vivant (voir ImageRegistry)
+  void adopt(std::shared_ptr<uint8_t> data, size_t size, BufferRegion region);
+  std::weak_ptr<uint8_t> get_weak() const { return this->shared_; }
+  long get_share_count() const;
+
+  uint8_t *data() { return this->data_; }
+  const uint8_t *data() const { return this->data_; }
+  size_t size() const { return this->size_; }
+  size_t capacity() const { return this->capacity_; }
+  bool empty() const { return this->size_ == 0; }
+  bool is_external() const { return this->region_ == BufferRegion::external; }
+  BufferRegion get_region() const { return this->region_; }
+
+  // Buffers plus grands que ce seuil vont en PSRAM en mode automatic
+  static const size_t AUTO_PSRAM_THRESHOLD = 16 * 1024;
+  static const RegionUsage &get_usage(BufferRegion region);
+  static const char *region_to_string(BufferRegion region);
+
+ protected:
+  uint8_t *allocate_in(BufferRegion region, size_t size);
+  static void free_in(BufferRegion region, uint8_t *data, size_t capacity);
+
+  uint8_t *data_{nullptr};
+  size_t size_{0};
+  size_t capacity_{0};
+  BufferPlacement placement_{BufferPlacement::automatic};
+  BufferRegion region_{BufferRegion::none};
+  // Propriétaire commun quand le buffer est partagé, vide sinon
+  std::shared_ptr<uint8_t> shared_;
+};
+
+}  // namespace storage
+}  // namespace esphome
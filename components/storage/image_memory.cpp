@@ -0,0 +1,148 @@
+#include "image_memory.h"
+#include "storage.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace storage {
+
+static const char *const TAG = "storage.memory";
+
+ImageMemoryManager *ImageMemoryManager::get_instance() {
+  static ImageMemoryManager instance;
+  return &instance;
+}
+
+ImageMemoryManager::Entry *ImageMemoryManager::find(SdImageComponent *image) {
+  for (auto &entry : this->entries_) {
+    if (entry.image == image) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+void ImageMemoryManager::on_loaded(SdImageComponent *image, const void *buffer, size_t bytes) {
+  Entry *entry = this->find(image);
+  if (entry == nullptr) {
+    this->entries_.push_back({image, nullptr, 0, 0});
+    entry = &this->entries_.back();
+  }
+  entry->buffer = buffer;
+  entry->bytes = bytes;
+  entry->last_used = ++this->tick_;
+  this->update_resident_bytes();
+
+  this->enforce_budget(image);
+}
+
+void ImageMemoryManager::on_unloaded(SdImageComponent *image) {
+  for (auto it = this->entries_.begin(); it != this->entries_.end(); ++it) {
+    if (it->image == image) {
+      this->entries_.erase(it);
+      this->update_resident_bytes();
+      return;
+    }
+  }
+}
+
+// Somme des buffers distincts: un buffer partagé n'est compté qu'une fois
+void ImageMemoryManager::update_resident_bytes() {
+  size_t total = 0;
+  for (size_t i = 0; i < this->entries_.size(); i++) {
+    bool counted = false;
+    for (size_t j = 0; j < i && !counted; j++) {
+      counted = this->entries_[j].buffer == this->entries_[i].buffer;
+    }
+    if (!counted) {
+      total += this->entries_[i].bytes;
+    }
+  }
+  this->resident_bytes_ = total;
+}
+
+void ImageMemoryManager::on_drawn(SdImageComponent *image) {
+  Entry *entry = this->find(image);
+  if (entry != nullptr) {
+    entry->last_used = ++this->tick_;
+  }
+}
+
+// Évince les buffers les moins récemment dessinés jusqu'à repasser sous le
+// budget. Un buffer partagé n'est libéré qu'en évinçant tous ses détenteurs,
+// et date du dernier draw de l'un d'eux; celui de l'image qui vient d'être
+// chargée n'est jamais évincé
+void ImageMemoryManager::enforce_budget(SdImageComponent *keep) {
+  if (this->budget_ == 0) {
+    return;
+  }
+  Entry *kept = this->find(keep);
+  const void *keep_buffer = kept != nullptr ? kept->buffer : nullptr;
+
+  while (this->resident_bytes_ > this->budget_) {
+    const void *victim = nullptr;
+    uint32_t victim_used = 0;
+    for (auto &entry : this->entries_) {
+      if (entry.buffer == keep_buffer) {
+        continue;
+      }
+      uint32_t used = 0;
+      for (auto &holder : this->entries_) {
+        if (holder.buffer == entry.buffer) {
+          used = std::max(used, holder.last_used);
+        }
+      }
+      if (victim == nullptr || used < victim_used) {
+        victim = entry.buffer;
+        victim_used = used;
+      }
+    }
+    if (victim == nullptr) {
+      ESP_LOGW(TAG, "Image alone exceeds the memory budget: %zu/%zu bytes", this->resident_bytes_, this->budget_);
+      return;
+    }
+
+    std::vector<SdImageComponent *> holders;
+    for (auto it = this->entries_.begin(); it != this->entries_.end();) {
+      if (it->buffer == victim) {
+        ESP_LOGD(TAG, "Evicting %s (%zu bytes)", it->image->get_file_path().c_str(), it->bytes);
+        holders.push_back(it->image);
+        it = this->entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    this->update_resident_bytes();
+    this->evictions_ += holders.size();
+    for (auto *image : holders) {
+      image->evict();
+    }
+  }
+}
+
+#ifdef USE_SENSOR
+void ImageMemorySensor::update() {
+  ImageMemoryManager *manager = ImageMemoryManager::get_instance();
+  if (this->resident_bytes_sensor_ != nullptr) {
+    this->resident_bytes_sensor_->publish_state(manager->get_resident_bytes());
+  }
+  if (this->evictions_sensor_ != nullptr) {
+    this->evictions_sensor_->publish_state(manager->get_evictions());
+  }
+  if (this->reloads_sensor_ != nullptr) {
+    this->reloads_sensor_->publish_state(manager->get_reloads());
+  }
+}
+
+void ImageMemorySensor::dump_config() {
+  ESP_LOGCONFIG(TAG, "Image Memory Sensor:");
+  ESP_LOGCONFIG(TAG, "  Budget: %zu bytes", ImageMemoryManager::get_instance()->get_budget());
+  LOG_SENSOR("  ", "Resident Bytes", this->resident_bytes_sensor_);
+  LOG_SENSOR("  ", "Evictions", this->evictions_sensor_);
+  LOG_SENSOR("  ", "Reloads", this->reloads_sensor_);
+}
+#endif
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "esphome/core/component.h"
+
+#ifdef USE_SENSOR
+#include "esphome/components/sensor/sensor.h"
+#endif
+
+namespace esphome {
+namespace storage {
+
+class SdImageComponent;
+
+// Budget mémoire partagé par toutes les images chargées en RAM. Chaque image
+// en cache s'y enregistre; au-delà du budget, les images dessinées le moins
+// récemment sont évincées et rechargées au prochain draw(). Un buffer partagé
+// entre plusieurs images (voir ImageRegistry) n'est compté qu'une fois, et
+// évincé avec tous ses détenteurs. Appelé uniquement depuis la boucle principale.
+class ImageMemoryManager {
+ public:
+  static ImageMemoryManager *get_instance();
+
+  // 0 = pas de limite (suivi seul)
+  void set_budget(size_t budget) { this->budget_ = budget; }
+  size_t get_budget() const { return this->budget_; }
+
+  // `bytes` octets résidents pour cette image dans `buffer`; évince les autres si besoin
+  void on_loaded(SdImageComponent *image, const void *buffer, size_t bytes);
+  void on_unloaded(SdImageComponent *image);
+  void on_drawn(SdImageComponent *image);
+  void on_reloaded() { this->reloads_++; }
+
+  size_t get_resident_bytes() const { return this->resident_bytes_; }
+  size_t get_image_count() const { return this->entries_.size(); }
+  uint32_t get_evictions() const { return this->evictions_; }
+  uint32_t get_reloads() const { return this->reloads_; }
+
+ protected:
+  struct Entry {
+    SdImageComponent *image;
+    const void *buffer;
+    size_t bytes;
+    uint32_t last_used;
+  };
+
+  Entry *find(SdImageComponent *image);
+  void enforce_budget(SdImageComponent *keep);
+  void update_resident_bytes();
+
+  std::vector<Entry> entries_;
+  size_t budget_{0};
+  size_t resident_bytes_{0};
+  uint32_t tick_{0};
+  uint32_t evictions_{0};
+  uint32_t reloads_{0};
+};
+
+#ifdef USE_SENSOR
+// Publie l'état du budget mémoire des images
+class ImageMemorySensor : public PollingComponent {
+ public:
+  void update() override;
+  void dump_config() override;
+
+  void set_resident_bytes_sensor(sensor::Sensor *sensor) { this->resident_bytes_sensor_ = sensor; }
+  void set_evictions_sensor(sensor::Sensor *sensor) { this->evictions_sensor_ = sensor; }
+  void set_reloads_sensor(sensor::Sensor *sensor) { this->reloads_sensor_ = sensor; }
+
+ protected:
+  sensor::Sensor *resident_bytes_sensor_{nullptr};
+  sensor::Sensor *evictions_sensor_{nullptr};
+  sensor::Sensor *reloads_sensor_{nullptr};
+};
+#endif
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,87 @@
+#include "image_registry.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace storage {
+
+static const char *const TAG = "storage.registry";
+
+ImageRegistry *ImageRegistry::get_instance() {
+  static ImageRegistry instance;
+  return &instance;
+}
+
+bool ImageRegistry::acquire(const std::string &key, LoadedImage &image) {
+  LockGuard guard(this->mutex_);
+  auto it = this->entries_.find(key);
+  if (it == this->entries_.end()) {
+    return false;
+  }
+
+  std::shared_ptr<uint8_t> data = it->second.data.lock();
+  if (!data) {
+    this->entries_.erase(it);
+    return false;
+  }
+
+  const Entry &entry = it->second;
+  image.data.adopt(std::move(data), entry.size, entry.region);
+  image.width = entry.width;
+  image.height = entry.height;
+  image.format = entry.format;
+  image.row_stride = entry.row_stride;
+  image.index_bits = entry.index_bits;
+  image.palette = entry.palette;
+  image.chroma_key = entry.chroma_key;
+  this->hits_++;
+  ESP_LOGD(TAG, "Sharing decoded image %s (%zu bytes)", image.path.c_str(), entry.size);
+  return true;
+}
+
+void ImageRegistry::publish(const std::string &key, LoadedImage &image) {
+  ImageBuffer shared = image.data.share();
+  if (shared.empty()) {
+    return;
+  }
+
+  LockGuard guard(this->mutex_);
+  this->prune();
+  Entry entry;
+  entry.data = shared.get_weak();
+  entry.size = shared.size();
+  entry.region = shared.get_region();
+  entry.width = image.width;
+  entry.height = image.height;
+  entry.format = image.format;
+  entry.row_stride = image.row_stride;
+  entry.index_bits = image.index_bits;
+  entry.palette = image.palette;
+  entry.chroma_key = image.chroma_key;
+  this->entries_[key] = std::move(entry);
+}
+
+size_t ImageRegistry::get_bytes_saved() {
+  LockGuard guard(this->mutex_);
+  size_t saved = 0;
+  for (const auto &it : this->entries_) {
+    long holders = it.second.data.use_count();
+    if (holders > 1) {
+      saved += it.second.size * static_cast<size_t>(holders - 1);
+    }
+  }
+  return saved;
+}
+
+// Oublie les images dont tous les détenteurs ont disparu
+void ImageRegistry::prune() {
+  for (auto it = this->entries_.begin(); it != this->entries_.end();) {
+    if (it->second.data.expired()) {
+      it = this->entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace storage
+}  // namespace esphome
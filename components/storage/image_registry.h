@@ -0,0 +1,54 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "esphome/core/helpers.h"
+#include "storage.h"
+
+namespace esphome {
+namespace storage {
+
+// Registre des images décodées, partagé par tous les SdImageComponent. Une
+// image identique (même fichier, format, dimensions et ordre des octets) n'est
+// lue et décodée qu'une fois: les composants suivants reçoivent le même
+// buffer, compté par références. Le registre ne garde qu'une référence faible:
+// l'image disparaît avec son dernier détenteur.
+class ImageRegistry {
+ public:
+  static ImageRegistry *get_instance();
+
+  // Remplit `image` avec une copie partagée si la clé est encore vivante
+  bool acquire(const std::string &key, LoadedImage &image);
+  // Rend l'image décodée disponible pour les prochains acquire()
+  void publish(const std::string &key, LoadedImage &image);
+
+  uint32_t get_hits() const { return this->hits_; }
+  // Octets non alloués grâce au partage, pour les images actuellement chargées
+  size_t get_bytes_saved();
+
+ protected:
+  struct Entry {
+    std::weak_ptr<uint8_t> data;
+    size_t size;
+    BufferRegion region;
+    int width;
+    int height;
+    ImageFormat format;
+    size_t row_stride;
+    // Format indexé: la palette accompagne les indices partagés
+    uint8_t index_bits;
+    std::vector<uint8_t> palette;
+    bool chroma_key;
+  };
+
+  void prune();
+
+  // acquire()/publish() sont appelés depuis la tâche de chargement asynchrone
+  Mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  uint32_t hits_{0};
+};
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,423 @@
+#include "png_stream.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+#ifdef USE_ESP_IDF
+#include "miniz.h"
+#endif
+
+namespace esphome {
+namespace storage {
+
+static const char *const TAG = "storage.png";
+
+// Taille des lectures de données compressées (un secteur)
+static const size_t INPUT_CHUNK_SIZE = 512;
+static const size_t DICT_SIZE = 32768;
+
+static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+
+static inline uint32_t read_be32(const uint8_t *p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+PngStreamDecoder::PngStreamDecoder(ReadFunc read) : read_(std::move(read)) {}
+
+PngStreamDecoder::~PngStreamDecoder() = default;
+
+size_t PngStreamDecoder::get_output_pixel_size(OutputImageFormat format) {
+  switch (format) {
+    case OutputImageFormat::rgb888:
+      return 3;
+    case OutputImageFormat::rgba:
+      return 4;
+    case OutputImageFormat::rgb565:
+    default:
+      return 2;
+  }
+}
+
+size_t PngStreamDecoder::get_memory_usage() const {
+  size_t usage = INPUT_CHUNK_SIZE + DICT_SIZE + this->palette_.capacity() + this->out_row_.capacity() +
+                 this->cur_row_.capacity() + this->prev_row_.capacity();
+#ifdef USE_ESP_IDF
+  usage += sizeof(tinfl_decompressor);
+#endif
+  return usage;
+}
+
+size_t PngStreamDecoder::estimate_memory_usage(int width) {
+  size_t usage = INPUT_CHUNK_SIZE + DICT_SIZE + 256 * 4 + 2 * (static_cast<size_t>(width) * 8 + 1) +
+                 static_cast<size_t>(width) * 4;
+#ifdef USE_ESP_IDF
+  usage += sizeof(tinfl_decompressor);
+#endif
+  return usage;
+}
+
+bool PngStreamDecoder::read_header() {
+  uint8_t header[33];
+  if (!this->read_(0, sizeof(header), header)) {
+    ESP_LOGE(TAG, "Failed to read PNG header");
+    return false;
+  }
+  if (memcmp(header, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0 || memcmp(header + 12, "IHDR", 4) != 0) {
+    ESP_LOGE(TAG, "Not a PNG file");
+    return false;
+  }
+
+  this->width_ = read_be32(header + 16);
+  this->height_ = read_be32(header + 20);
+  this->bit_depth_ = header[24];
+  this->color_type_ = header[25];
+  uint8_t interlace = header[28];
+
+  switch (this->color_type_) {
+    case 0:  // Niveaux de gris
+    case 3:  // Palette
+      this->channels_ = 1;
+      break;
+    case 2:  // RGB
+      this->channels_ = 3;
+      break;
+    case 4:  // Niveaux de gris + alpha
+      this->channels_ = 2;
+      break;
+    case 6:  // RGBA
+      this->channels_ = 4;
+      break;
+    default:
+      ESP_LOGE(TAG, "Unsupported PNG color type %u", this->color_type_);
+      return false;
+  }
+  // Profondeurs admises par la spécification pour chaque type de couleur
+  bool depth_ok;
+  switch (this->color_type_) {
+    case 0:
+      depth_ok = this->bit_depth_ == 1 || this->bit_depth_ == 2 || this->bit_depth_ == 4 || this->bit_depth_ == 8 ||
+                 this->bit_depth_ == 16;
+      break;
+    case 3:
+      depth_ok = this->bit_depth_ == 1 || this->bit_depth_ == 2 || this->bit_depth_ == 4 || this->bit_depth_ == 8;
+      break;
+    default:
+      depth_ok = this->bit_depth_ == 8 || this->bit_depth_ == 16;
+      break;
+  }
+  if (!depth_ok) {
+    ESP_LOGE(TAG, "Invalid PNG bit depth %u for color type %u", this->bit_depth_, this->color_type_);
+    return false;
+  }
+  if (interlace != 0) {
+    ESP_LOGE(TAG, "Interlaced PNG images are not supported");
+    return false;
+  }
+  if (this->width_ <= 0 || this->height_ <= 0) {
+    ESP_LOGE(TAG, "Invalid PNG dimensions %dx%d", this->width_, this->height_);
+    return false;
+  }
+
+  size_t bits_per_pixel = this->bit_depth_ * this->channels_;
+  this->stride_ = (this->width_ * bits_per_pixel + 7) / 8;
+  this->filter_bpp_ = bits_per_pixel >= 8 ? bits_per_pixel / 8 : 1;
+  // Signature (8) + IHDR (4 longueur + 4 type + 13 données + 4 CRC)
+  this->pos_ = 33;
+  return true;
+}
+
+bool PngStreamDecoder::decode(OutputImageFormat format, const RowFunc &on_row) {
+#ifdef USE_ESP_IDF
+  if (this->stride_ == 0 && !this->read_header()) {
+    return false;
+  }
+
+  this->output_format_ = format;
+  this->on_row_ = &on_row;
+  this->out_row_.assign(this->width_ * get_output_pixel_size(format), 0);
+  this->cur_row_.assign(this->stride_ + 1, 0);
+  this->prev_row_.assign(this->stride_ + 1, 0);
+  this->row_fill_ = 0;
+  this->row_y_ = 0;
+  this->input_.reset(new uint8_t[INPUT_CHUNK_SIZE]);
+  this->dict_.reset(new uint8_t[DICT_SIZE]);
+  this->dict_ofs_ = 0;
+  this->inflator_.reset(new tinfl_decompressor);
+  tinfl_init(this->inflator_.get());
+  this->done_ = false;
+
+  bool ok = true;
+  while (ok && !this->done_) {
+    uint8_t chunk_header[8];
+    if (!this->read_(this->pos_, sizeof(chunk_header), chunk_header)) {
+      ESP_LOGE(TAG, "Truncated PNG at offset %zu", this->pos_);
+      ok = false;
+      break;
+    }
+    this->pos_ += sizeof(chunk_header);
+    uint32_t length = read_be32(chunk_header);
+    const uint8_t *type = chunk_header + 4;
+
+    if (memcmp(type, "IDAT", 4) == 0) {
+      uint32_t remaining = length;
+      while (remaining > 0 && !this->done_) {
+        size_t n = std::min<size_t>(remaining, INPUT_CHUNK_SIZE);
+        if (!this->read_(this->pos_, n, this->input_.get())) {
+          ESP_LOGE(TAG, "Failed to read IDAT data at offset %zu", this->pos_);
+          ok = false;
+          break;
+        }
+        this->pos_ += n;
+        remaining -= n;
+        if (!this->feed(this->input_.get(), n)) {
+          ok = false;
+          break;
+        }
+      }
+      this->pos_ += remaining;
+    } else if (memcmp(type, "PLTE", 4) == 0 && length <= 256 * 3) {
+      uint8_t rgb[256 * 3];
+      if (!this->read_(this->pos_, length, rgb)) {
+        ok = false;
+        break;
+      }
+      size_t entries = length / 3;
+      this->palette_.assign(entries * 4, 0xFF);
+      for (size_t i = 0; i < entries; i++) {
+        memcpy(&this->palette_[i * 4], &rgb[i * 3], 3);
+      }
+      this->pos_ += length;
+    } else if (memcmp(type, "tRNS", 4) == 0 && this->color_type_ == 3 && length <= 256) {
+      uint8_t alpha[256];
+      if (!this->read_(this->pos_, length, alpha)) {
+        ok = false;
+        break;
+      }
+      for (size_t i = 0; i < length && i * 4 + 3 < this->palette_.size(); i++) {
+        this->palette_[i * 4 + 3] = alpha[i];
+      }
+      this->pos_ += length;
+    } else if (memcmp(type, "IEND", 4) == 0) {
+      break;
+    } else {
+      // Chunk auxiliaire ignoré
+      this->pos_ += length;
+    }
+    // CRC
+    this->pos_ += 4;
+  }
+
+  if (ok && this->row_y_ < this->height_) {
+    ESP_LOGE(TAG, "PNG data ended after %d of %d rows", this->row_y_, this->height_);
+    ok = false;
+  }
+
+  // Libérer la fenêtre et l'état de l'inflateur dès la fin du décodage
+  this->inflator_.reset();
+  this->dict_.reset();
+  this->input_.reset();
+  this->on_row_ = nullptr;
+  return ok;
+#else
+  ESP_LOGE(TAG, "PNG decoding requires ESP-IDF (miniz)");
+  return false;
+#endif
+}
+
+bool PngStreamDecoder::feed(const uint8_t *data, size_t length) {
+#ifdef USE_ESP_IDF
+  const uint32_t flags = TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT;
+  while (!this->done_) {
+    size_t in_bytes = length;
+    size_t out_bytes = DICT_SIZE - this->dict_ofs_;
+    tinfl_status status = tinfl_decompress(this->inflator_.get(), data, &in_bytes, this->dict_.get(),
+                                           this->dict_.get() + this->dict_ofs_, &out_bytes, flags);
+    data += in_bytes;
+    length -= in_bytes;
+
+    if (out_bytes > 0) {
+      if (!this->push_bytes(this->dict_.get() + this->dict_ofs_, out_bytes)) {
+        return false;
+      }
+      this->dict_ofs_ = (this->dict_ofs_ + out_bytes) & (DICT_SIZE - 1);
+    }
+
+    if (status == TINFL_STATUS_DONE) {
+      this->done_ = true;
+    } else if (status < 0) {
+      ESP_LOGE(TAG, "Inflate failed (%d)", (int) status);
+      return false;
+    } else if (status == TINFL_STATUS_NEEDS_MORE_INPUT && length == 0) {
+      return true;
+    } else if (in_bytes == 0 && out_bytes == 0 && status != TINFL_STATUS_HAS_MORE_OUTPUT) {
+      return true;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool PngStreamDecoder::push_bytes(const uint8_t *data, size_t length) {
+  const size_t row_size = this->stride_ + 1;
+  while (length > 0 && this->row_y_ < this->height_) {
+    size_t n = std::min(length, row_size - this->row_fill_);
+    memcpy(this->cur_row_.data() + this->row_fill_, data, n);
+    this->row_fill_ += n;
+    data += n;
+    length -= n;
+
+    if (this->row_fill_ == row_size) {
+      if (this->cur_row_[0] > 4) {
+        ESP_LOGE(TAG, "Invalid PNG filter %u on row %d", this->cur_row_[0], this->row_y_);
+        return false;
+      }
+      this->unfilter_row();
+      this->convert_row();
+      (*this->on_row_)(this->row_y_, this->out_row_.data());
+      std::swap(this->cur_row_, this->prev_row_);
+      this->row_fill_ = 0;
+      this->row_y_++;
+    }
+  }
+  return true;
+}
+
+void PngStreamDecoder::unfilter_row() {
+  uint8_t *row = this->cur_row_.data() + 1;
+  const uint8_t *prev = this->prev_row_.data() + 1;
+  const size_t bpp = this->filter_bpp_;
+  const size_t n = this->stride_;
+
+  switch (this->cur_row_[0]) {
+    case 1:  // Sub
+      for (size_t i = bpp; i < n; i++)
+        row[i] += row[i - bpp];
+      break;
+    case 2:  // Up
+      for (size_t i = 0; i < n; i++)
+        row[i] += prev[i];
+      break;
+    case 3:  // Average
+      for (size_t i = 0; i < n; i++) {
+        uint8_t left = i >= bpp ? row[i - bpp] : 0;
+        row[i] += (left + prev[i]) >> 1;
+      }
+      break;
+    case 4:  // Paeth
+      for (size_t i = 0; i < n; i++) {
+        int a = i >= bpp ? row[i - bpp] : 0;
+        int b = prev[i];
+        int c = i >= bpp ? prev[i - bpp] : 0;
+        int p = a + b - c;
+        int pa = abs(p - a);
+        int pb = abs(p - b);
+        int pc = abs(p - c);
+        row[i] += (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+      }
+      break;
+    default:  // None
+      break;
+  }
+}
+
+void PngStreamDecoder::get_rgba(int x, uint8_t &red, uint8_t &green, uint8_t &blue, uint8_t &alpha) const {
+  const uint8_t *row = this->cur_row_.data() + 1;
+
+  if (this->bit_depth_ < 8) {
+    // Échantillons empaquetés (1, 2 ou 4 bits), uniquement gris ou palette
+    size_t bit = static_cast<size_t>(x) * this->bit_depth_;
+    uint8_t mask = (1 << this->bit_depth_) - 1;
+    uint8_t value = (row[bit / 8] >> (8 - this->bit_depth_ - (bit % 8))) & mask;
+    if (this->color_type_ == 3) {
+      if (value * 4u + 3 < this->palette_.size()) {
+        const uint8_t *entry = &this->palette_[value * 4];
+        red = entry[0];
+        green = entry[1];
+        blue = entry[2];
+        alpha = entry[3];
+      } else {
+        red = green = blue = 0;
+        alpha = 0xFF;
+      }
+    } else {
+      red = green = blue = value * 255 / mask;
+      alpha = 0xFF;
+    }
+    return;
+  }
+
+  // 8 ou 16 bits par échantillon: seul l'octet de poids fort est utilisé
+  const size_t sample_bytes = this->bit_depth_ / 8;
+  const uint8_t *p = row + static_cast<size_t>(x) * this->channels_ * sample_bytes;
+  switch (this->color_type_) {
+    case 0:
+      red = green = blue = p[0];
+      alpha = 0xFF;
+      break;
+    case 2:
+      red = p[0];
+      green = p[sample_bytes];
+      blue = p[2 * sample_bytes];
+      alpha = 0xFF;
+      break;
+    case 3:
+      if (p[0] * 4u + 3 < this->palette_.size()) {
+        const uint8_t *entry = &this->palette_[p[0] * 4];
+        red = entry[0];
+        green = entry[1];
+        blue = entry[2];
+        alpha = entry[3];
+      } else {
+        red = green = blue = 0;
+        alpha = 0xFF;
+      }
+      break;
+    case 4:
+      red = green = blue = p[0];
+      alpha = p[sample_bytes];
+      break;
+    case 6:
+    default:
+      red = p[0];
+      green = p[sample_bytes];
+      blue = p[2 * sample_bytes];
+      alpha = p[3 * sample_bytes];
+      break;
+  }
+}
+
+void PngStreamDecoder::convert_row() {
+  uint8_t *out = this->out_row_.data();
+  for (int x = 0; x < this->width_; x++) {
+    uint8_t red, green, blue, alpha;
+    this->get_rgba(x, red, green, blue, alpha);
+    switch (this->output_format_) {
+      case OutputImageFormat::rgb888:
+        *out++ = red;
+        *out++ = green;
+        *out++ = blue;
+        break;
+      case OutputImageFormat::rgba:
+        *out++ = red;
+        *out++ = green;
+        *out++ = blue;
+        *out++ = alpha;
+        break;
+      case OutputImageFormat::rgb565:
+      default: {
+        // Little-endian, comme les données RGB565 en RAM
+        uint16_t pixel = ((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3);
+        *out++ = pixel & 0xFF;
+        *out++ = pixel >> 8;
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace storage
+}  // namespace esphome
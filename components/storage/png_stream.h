@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "storage.h"
+
+#ifdef USE_ESP_IDF
+struct tinfl_decompressor_tag;
+#endif
+
+namespace esphome {
+namespace storage {
+
+// Décodeur PNG en flux: les chunks sont lus par petits morceaux depuis la
+// source, décompressés dans la fenêtre zlib (32 Ko) et chaque ligne est
+// émise dès qu'elle est complète. La RAM utilisée est bornée par la fenêtre
+// zlib, l'état de l'inflateur et deux lignes, quelle que soit la taille du
+// fichier ou de l'image.
+class PngStreamDecoder {
+ public:
+  // Lit exactement `length` octets à `offset` dans la source
+  using ReadFunc = std::function<bool(size_t offset, size_t length, uint8_t *dst)>;
+  // Reçoit chaque ligne décodée, déjà convertie au format de sortie
+  using RowFunc = std::function<void(int y, const uint8_t *row)>;
+
+  explicit PngStreamDecoder(ReadFunc read);
+  ~PngStreamDecoder();
+
+  // Lit la signature et le chunk IHDR
+  bool read_header();
+  // Décode toute l'image et appelle `on_row` pour chaque ligne
+  bool decode(OutputImageFormat format, const RowFunc &on_row);
+
+  int get_width() const { return this->width_; }
+  int get_height() const { return this->height_; }
+  size_t get_memory_usage() const;
+
+  static size_t get_output_pixel_size(OutputImageFormat format);
+  // Pic de RAM d'un décodage, dans le pire cas (RGBA 16 bits) pour cette largeur
+  static size_t estimate_memory_usage(int width);
+
+ protected:
+  bool feed(const uint8_t *data, size_t length);
+  bool push_bytes(const uint8_t *data, size_t length);
+  void unfilter_row();
+  void convert_row();
+  void get_rgba(int x, uint8_t &red, uint8_t &green, uint8_t &blue, uint8_t &alpha) const;
+
+  ReadFunc read_;
+  size_t pos_{0};
+  std::unique_ptr<uint8_t[]> input_;
+
+  // IHDR
+  int width_{0};
+  int height_{0};
+  uint8_t bit_depth_{0};
+  uint8_t color_type_{0};
+  uint8_t channels_{0};
+  size_t stride_{0};
+  size_t filter_bpp_{1};
+
+  // Palette (PLTE + tRNS), au format RGBA
+  std::vector<uint8_t> palette_;
+
+  // Sortie
+  OutputImageFormat output_format_{OutputImageFormat::rgb565};
+  const RowFunc *on_row_{nullptr};
+  std::vector<uint8_t> out_row_;
+
+  // Deux lignes filtrées (octet de filtre inclus): courante et précédente
+  std::vector<uint8_t> cur_row_;
+  std::vector<uint8_t> prev_row_;
+  size_t row_fill_{0};
+  int row_y_{0};
+
+#ifdef USE_ESP_IDF
+  std::unique_ptr<tinfl_decompressor_tag> inflator_;
+#endif
+  std::unique_ptr<uint8_t[]> dict_;
+  size_t dict_ofs_{0};
+  bool done_{false};
+};
+
+}  // namespace storage
+}  // namespace esphome
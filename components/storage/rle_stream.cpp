@@ -0,0 +1,105 @@
+#include "rle_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace esphome {
+namespace storage {
+
+RleRowDecoder::RleRowDecoder(ReadFunc read, size_t offset, size_t size, size_t unit, size_t row_size)
+    : read_(std::move(read)), offset_(offset), size_(size), unit_(unit), row_size_(row_size) {}
+
+bool RleRowDecoder::fill() {
+  size_t length = std::min(INPUT_SIZE, this->size_ - this->consumed_);
+  if (length == 0 || !this->read_(this->offset_ + this->consumed_, length, this->input_)) {
+    return false;
+  }
+  this->consumed_ += length;
+  this->input_pos_ = 0;
+  this->input_len_ = length;
+  return true;
+}
+
+bool RleRowDecoder::read_bytes(uint8_t *dst, size_t count) {
+  while (count > 0) {
+    if (this->input_pos_ == this->input_len_ && !this->fill()) {
+      return false;
+    }
+    size_t n = std::min(count, this->input_len_ - this->input_pos_);
+    memcpy(dst, this->input_ + this->input_pos_, n);
+    this->input_pos_ += n;
+    dst += n;
+    count -= n;
+  }
+  return true;
+}
+
+bool RleRowDecoder::decode_row(uint8_t *dst) {
+  size_t filled = 0;
+  while (filled < this->row_size_) {
+    uint8_t control;
+    if (!this->read_bytes(&control, 1)) {
+      return false;
+    }
+    if (control < 128) {
+      size_t length = (control + 1) * this->unit_;
+      if (filled + length > this->row_size_ || !this->read_bytes(dst + filled, length)) {
+        return false;
+      }
+      filled += length;
+    } else {
+      size_t length = (control - 126) * this->unit_;
+      if (filled + length > this->row_size_ || !this->read_bytes(dst + filled, this->unit_)) {
+        return false;
+      }
+      // Recopie par blocs doublés: log2(n) memcpy au lieu d'une boucle par pixel
+      size_t done = this->unit_;
+      while (done < length) {
+        size_t n = std::min(done, length - done);
+        memcpy(dst + filled + done, dst + filled, n);
+        done += n;
+      }
+      filled += length;
+    }
+  }
+  return true;
+}
+
+void RleRowDecoder::seek(size_t position) {
+  this->consumed_ = std::min(position, this->size_);
+  this->input_pos_ = 0;
+  this->input_len_ = 0;
+}
+
+bool RleRowDecoder::skip_bytes(size_t count) {
+  while (count > 0) {
+    if (this->input_pos_ == this->input_len_ && !this->fill()) {
+      return false;
+    }
+    size_t n = std::min(count, this->input_len_ - this->input_pos_);
+    this->input_pos_ += n;
+    count -= n;
+  }
+  return true;
+}
+
+// Suit les octets de contrôle sans rien écrire
+bool RleRowDecoder::skip_row() {
+  size_t filled = 0;
+  while (filled < this->row_size_) {
+    uint8_t control;
+    if (!this->read_bytes(&control, 1)) {
+      return false;
+    }
+    size_t count = control < 128 ? control + 1 : control - 126;
+    filled += count * this->unit_;
+    if (filled > this->row_size_ || !this->skip_bytes(control < 128 ? count * this->unit_ : this->unit_)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace esphome {
+namespace storage {
+
+// Décodeur des pixels compressés RLE du conteneur (voir encode_rle_rows()
+// dans __init__.py). Chaque ligne est codée indépendamment, par unités d'un
+// pixel (un octet pour le binaire): un octet de contrôle c < 128 annonce
+// c + 1 pixels littéraux, c >= 128 répète c - 126 fois le pixel qui suit.
+// Les données compressées sont lues par morceaux de INPUT_SIZE octets: la
+// RAM utilisée ne dépend pas de la taille de l'image.
+class RleRowDecoder {
+ public:
+  // Lit exactement `length` octets à `offset` dans le fichier
+  using ReadFunc = std::function<bool(size_t offset, size_t length, uint8_t *dst)>;
+
+  static constexpr size_t INPUT_SIZE = 512;
+
+  // Payload compressé de `size` octets à `offset`; lignes de `row_size`
+  // octets faites d'unités de `unit` octets
+  RleRowDecoder(ReadFunc read, size_t offset, size_t size, size_t unit, size_t row_size);
+
+  // Décode la ligne suivante dans `dst` (row_size octets)
+  bool decode_row(uint8_t *dst);
+  // Passe la ligne suivante sans la garder
+  bool skip_row();
+  // Reprend au début d'une ligne, `position` octets après le début du
+  // payload (voir l'index des lignes de ImageAssetHeader)
+  void seek(size_t position);
+
+ protected:
+  bool fill();
+  bool read_bytes(uint8_t *dst, size_t count);
+  bool skip_bytes(size_t count);
+
+  ReadFunc read_;
+  size_t offset_;
+  size_t size_;
+  size_t unit_;
+  size_t row_size_;
+  // Octets du payload déjà chargés dans input_
+  size_t consumed_{0};
+  uint8_t input_[INPUT_SIZE];
+  size_t input_pos_{0};
+  size_t input_len_{0};
+};
+
+}  // namespace storage
+}  // namespace esphome
@@ -0,0 +1,57 @@
+import esphome.codegen as cg
+from esphome.components import sensor
+import esphome.config_validation as cv
+from esphome.const import (
+    CONF_ID,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_MEMORY,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_BYTES,
+)
+
+CONF_RESIDENT_BYTES = "resident_bytes"
+CONF_EVICTIONS = "evictions"
+CONF_RELOADS = "reloads"
+
+storage_ns = cg.esphome_ns.namespace("storage")
+ImageMemorySensor = storage_ns.class_("ImageMemorySensor", cg.PollingComponent)
+
+# Diagnostic du budget mémoire partagé par toutes les images de la carte SD
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(ImageMemorySensor),
+        cv.Optional(CONF_RESIDENT_BYTES): sensor.sensor_schema(
+            unit_of_measurement=UNIT_BYTES,
+            icon=ICON_MEMORY,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_EVICTIONS): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_RELOADS): sensor.sensor_schema(
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+).extend(cv.polling_component_schema("60s"))
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    if conf := config.get(CONF_RESIDENT_BYTES):
+        sens = await sensor.new_sensor(conf)
+        cg.add(var.set_resident_bytes_sensor(sens))
+    if conf := config.get(CONF_EVICTIONS):
+        sens = await sensor.new_sensor(conf)
+        cg.add(var.set_evictions_sensor(sens))
+    if conf := config.get(CONF_RELOADS):
+        sens = await sensor.new_sensor(conf)
+        cg.add(var.set_reloads_sensor(sens))
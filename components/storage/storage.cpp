@@ -1,14 +1,202 @@
 #include "storage.h"
+#include "png_stream.h"
+#include "image_asset.h"
+#include "rle_stream.h"
+#include "image_memory.h"
+#include "image_registry.h"
 #include "esphome/core/log.h"
 #include "esphome/core/hal.h"
 #include "esphome/components/display/display.h"
 
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifdef USE_ESP_IDF
+#include "jpeg_decoder.h"
+#endif
+
+#if defined(USE_ESP32)
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#elif defined(USE_HOST)
+#include <thread>
+#endif
+
 namespace esphome {
 namespace storage {
 
 static const char *const TAG = "storage";
 static const char *const TAG_IMAGE = "storage.sd_image";
 
+// Dimensions maximales acceptées par validate_dimensions()
+static const int MAX_IMAGE_WIDTH = 1024;
+static const int MAX_IMAGE_HEIGHT = 768;
+
+// Pile de la tâche de chargement asynchrone (décodeurs JPEG/PNG inclus)
+static const uint32_t LOAD_TASK_STACK_SIZE = 8192;
+
+// Plus bas niveau de heap interne libre depuis le démarrage (0 si inconnu)
+static size_t get_internal_heap_low_water() {
+#ifdef USE_ESP32
+  return heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+#else
+  return 0;
+#endif
+}
+
+static const char *buffer_placement_to_string(BufferPlacement placement) {
+  switch (placement) {
+    case BufferPlacement::psram:
+      return "PSRAM";
+    case BufferPlacement::internal:
+      return "Internal";
+    case BufferPlacement::automatic:
+    default:
+      return "Auto";
+  }
+}
+
+// ======== Noyaux de conversion de lignes ========
+//
+// Un noyau par format source, choisi une seule fois par draw(): la boucle
+// interne ne contient plus aucun switch sur le format. Les formats de moins
+// d'un octet par pixel (binaire, indexé) passent par des tables, plus bas.
+
+using RowKernel = void (*)(const uint8_t *src, int count, Color *dst, uint8_t *alpha);
+
+// Couleur clé des images `chroma_key`, telle qu'écrite par les encodeurs de
+// __init__.py: RGB565 0x0020, RGB (0, 1, 0), niveau de gris 1
+template<ImageFormat F> static inline bool is_chroma_key(const uint8_t *pixel) {
+  if constexpr (F == ImageFormat::rgb565) {
+    return pixel[0] == 0x20 && pixel[1] == 0x00;
+  } else if constexpr (F == ImageFormat::grayscale) {
+    return pixel[0] == 1;
+  } else {
+    return pixel[0] == 0 && pixel[1] == 1 && pixel[2] == 0;
+  }
+}
+
+// ChromaKey: alpha à 0 pour la couleur clé, 255 ailleurs
+template<ImageFormat F, bool HasAlpha, bool ChromaKey = false>
+static void convert_row(const uint8_t *src, int count, Color *dst, uint8_t *alpha) {
+  for (int i = 0; i < count; i++) {
+    if constexpr (ChromaKey) {
+      alpha[i] = is_chroma_key<F>(src) ? 0 : 255;
+    }
+    if constexpr (F == ImageFormat::rgb565) {
+      uint16_t pixel = (src[1] << 8) | src[0];
+      dst[i] = Color(((pixel >> 11) & 0x1F) << 3, ((pixel >> 5) & 0x3F) << 2, (pixel & 0x1F) << 3);
+      src += 2;
+    } else if constexpr (F == ImageFormat::grayscale) {
+      dst[i] = Color(src[0], src[0], src[0]);
+      src += 1;
+    } else if constexpr (F == ImageFormat::rgba) {
+      dst[i] = Color(src[0], src[1], src[2]);
+      src += 4;
+    } else {
+      dst[i] = Color(src[0], src[1], src[2]);
+      src += 3;
+    }
+    if constexpr (HasAlpha) {
+      // L'alpha est toujours le dernier octet du pixel
+      alpha[i] = src[-1];
+    }
+  }
+}
+
+static RowKernel select_row_kernel(ImageFormat format, bool chroma_key, bool &has_alpha) {
+  has_alpha = chroma_key;
+  switch (format) {
+    case ImageFormat::rgb565:
+      return chroma_key ? convert_row<ImageFormat::rgb565, false, true> : convert_row<ImageFormat::rgb565, false>;
+    case ImageFormat::rgb888:
+      return chroma_key ? convert_row<ImageFormat::rgb888, false, true> : convert_row<ImageFormat::rgb888, false>;
+    case ImageFormat::rgba:
+      has_alpha = true;
+      return convert_row<ImageFormat::rgba, true>;
+    case ImageFormat::grayscale:
+      return chroma_key ? convert_row<ImageFormat::grayscale, false, true>
+                        : convert_row<ImageFormat::grayscale, false>;
+    default:
+      return convert_row<ImageFormat::rgb565, false>;
+  }
+}
+
+static uint16_t to_rgb565(Color color) {
+  return ((color.r >> 3) << 11) | ((color.g >> 2) << 5) | (color.b >> 3);
+}
+
+template<typename T>
+static inline void expand_byte(uint8_t byte, const T *table, T *dst) {
+  dst[0] = table[byte >> 7];
+  dst[1] = table[(byte >> 6) & 1];
+  dst[2] = table[(byte >> 5) & 1];
+  dst[3] = table[(byte >> 4) & 1];
+  dst[4] = table[(byte >> 3) & 1];
+  dst[5] = table[(byte >> 2) & 1];
+  dst[6] = table[(byte >> 1) & 1];
+  dst[7] = table[byte & 1];
+}
+
+// Un bit par pixel (table: éteint, allumé), lu par mots de 32 pixels. Les
+// mots tout éteints ou tout allumés, la majorité d'une page e-paper, sont
+// remplis d'un bloc; les autres sont développés octet par octet.
+template<typename T>
+static void expand_bits(const uint8_t *src, int count, const T *table, T *dst) {
+  int i = 0;
+  for (; i + 32 <= count; i += 32, src += 4) {
+    uint32_t word;
+    memcpy(&word, src, sizeof(word));  // lecture non alignée
+    if (word == 0) {
+      std::fill_n(dst + i, 32, table[0]);
+    } else if (word == 0xFFFFFFFF) {
+      std::fill_n(dst + i, 32, table[1]);
+    } else {
+      for (int k = 0; k < 4; k++)
+        expand_byte(src[k], table, dst + i + 8 * k);
+    }
+  }
+  for (; i + 8 <= count; i += 8, src++)
+    expand_byte(*src, table, dst + i);
+  for (int k = 0; i < count; i++, k++)
+    dst[i] = table[(*src >> (7 - k)) & 1];
+}
+
+// Format indexé: chaque indice est remplacé par son entrée dans une table
+// préconvertie (Color, alpha ou RGB565), octet source par octet source
+template<int Bits, typename T>
+static void expand_indices(const uint8_t *src, int count, const T *table, T *dst) {
+  constexpr int PER_BYTE = 8 / Bits;
+  constexpr uint8_t MASK = (1 << Bits) - 1;
+  int i = 0;
+  for (; i + PER_BYTE <= count; src++) {
+    const uint8_t byte = *src;
+    for (int k = 0; k < PER_BYTE; k++)
+      dst[i++] = table[(byte >> (8 - Bits * (k + 1))) & MASK];
+  }
+  for (int k = 0; i < count; k++)
+    dst[i++] = table[(*src >> (8 - Bits * (k + 1))) & MASK];
+}
+
+template<typename T>
+static void expand_indices(const uint8_t *src, uint8_t bits, int count, const T *table, T *dst) {
+  switch (bits) {
+    case 1:
+      expand_bits(src, count, table, dst);
+      break;
+    case 2:
+      expand_indices<2>(src, count, table, dst);
+      break;
+    case 4:
+      expand_indices<4>(src, count, table, dst);
+      break;
+    default:
+      expand_indices<8>(src, count, table, dst);
+      break;
+  }
+}
+
 // ======== StorageComponent Implementation ========
 
 void StorageComponent::setup() {
@@ -22,14 +210,37 @@ void StorageComponent::setup() {
   
   ESP_LOGD(TAG, "Platform: %s", this->platform_.c_str());
   if (this->cache_size_ > 0) {
-    ESP_LOGD(TAG, "Cache size: %zu bytes", this->cache_size_);
+    this->block_cache_.init(this->cache_size_);
+    ESP_LOGD(TAG, "Cache size: %zu bytes (%zu blocks of %zu bytes)", this->cache_size_,
+             this->block_cache_.get_block_count(), BlockCache::BLOCK_SIZE);
   }
   
   ESP_LOGCONFIG(TAG, "Storage Component setup complete");
 }
 
 void StorageComponent::loop() {
-  // Rien pour le moment
+  uint32_t now = millis();
+  if (now - this->last_stats_time_ >= READ_STATS_INTERVAL_MS) {
+    this->last_stats_time_ = now;
+    this->log_read_stats();
+  }
+}
+
+// Bilan des lectures depuis le précédent: octets lus sur la carte et taux de
+// hits du cache de blocs, rien si aucune lecture
+void StorageComponent::log_read_stats() {
+  LockGuard guard(this->io_mutex_);
+  uint32_t hits = this->block_cache_.get_hits() - this->logged_hits_;
+  uint32_t misses = this->block_cache_.get_misses() - this->logged_misses_;
+  size_t bytes = this->bytes_read_ - this->logged_bytes_read_;
+  if (hits == 0 && misses == 0 && bytes == 0) {
+    return;
+  }
+  ESP_LOGD(TAG, "Reads: %zu bytes from the card, block cache %u hits / %u misses (%.1f%%)", bytes,
+           (unsigned) hits, (unsigned) misses, hits + misses > 0 ? 100.0f * hits / (hits + misses) : 0.0f);
+  this->logged_hits_ += hits;
+  this->logged_misses_ += misses;
+  this->logged_bytes_read_ += bytes;
 }
 
 void StorageComponent::dump_config() {
@@ -37,43 +248,299 @@ void StorageComponent::dump_config() {
   ESP_LOGCONFIG(TAG, "  Platform: %s", this->platform_.c_str());
   ESP_LOGCONFIG(TAG, "  Cache Size: %zu bytes", this->cache_size_);
   ESP_LOGCONFIG(TAG, "  SD Component: %s", this->sd_component_ ? "Connected" : "Not Connected");
+  ESP_LOGCONFIG(TAG, "  Bytes Read: %zu", this->bytes_read_);
+  ESP_LOGCONFIG(TAG, "  Metadata Cache: %zu files, %u lookups saved / %u SD lookups", this->files_.size(),
+                (unsigned) this->metadata_hits_, (unsigned) this->metadata_misses_);
+  if (this->block_cache_.is_enabled()) {
+    uint32_t hits = this->block_cache_.get_hits();
+    uint32_t lookups = hits + this->block_cache_.get_misses();
+    ESP_LOGCONFIG(TAG, "  Block Cache: %zu blocks, %u hits / %u misses (%.1f%%), %u evictions",
+                  this->block_cache_.get_block_count(), (unsigned) hits, (unsigned) this->block_cache_.get_misses(),
+                  lookups > 0 ? 100.0f * hits / lookups : 0.0f, (unsigned) this->block_cache_.get_evictions());
+  }
 }
 
 bool StorageComponent::file_exists_direct(const std::string &path) {
+  LockGuard guard(this->io_mutex_);
   if (!this->sd_component_) {
     ESP_LOGE(TAG, "SD component not available");
     return false;
   }
   
-  return this->sd_component_->file_size(path) > 0;
+  return this->get_metadata(path).size > 0;
 }
 
 std::vector<uint8_t> StorageComponent::read_file_direct(const std::string &path) {
+  LockGuard guard(this->io_mutex_);
   if (!this->sd_component_) {
     ESP_LOGE(TAG, "SD component not available");
     return {};
   }
   
-  return this->sd_component_->read_file(path);
+  size_t size = this->get_metadata(path).size;
+  if (size == 0) {
+    ESP_LOGE(TAG, "File not found or empty: %s", path.c_str());
+    return {};
+  }
+  
+  // Même lecteur que read_range(): les petits fichiers (icônes, fonds) passent
+  // par le cache de blocs, les autres sont lus d'un bloc
+  std::vector<uint8_t> data(size);
+  if (this->is_cacheable(size)) {
+    if (!this->read_range_cached(path, 0, size, data.data())) {
+      return {};
+    }
+    return data;
+  }
+  size_t read = this->read_at(path, 0, size, data.data());
+  if (read != size) {
+    ESP_LOGW(TAG, "Short read on %s: %zu/%zu bytes", path.c_str(), read, size);
+    return {};
+  }
+  return data;
+}
+
+size_t StorageComponent::read_file_into(const std::string &path, uint8_t *dst, size_t capacity) {
+  if (dst == nullptr) {
+    return 0;
+  }
+  LockGuard guard(this->io_mutex_);
+  if (!this->sd_component_) {
+    ESP_LOGE(TAG, "SD component not available");
+    return 0;
+  }
+  
+  size_t size = this->get_metadata(path).size;
+  if (size == 0) {
+    ESP_LOGE(TAG, "File not found or empty: %s", path.c_str());
+    return 0;
+  }
+  if (size > capacity) {
+    ESP_LOGE(TAG, "Buffer too small for %s: %zu bytes needed, %zu available", path.c_str(), size, capacity);
+    return 0;
+  }
+  
+  if (this->is_cacheable(size)) {
+    return this->read_range_cached(path, 0, size, dst) ? size : 0;
+  }
+  size_t read = this->read_at(path, 0, size, dst);
+  if (read != size) {
+    ESP_LOGW(TAG, "Short read on %s: %zu/%zu bytes", path.c_str(), read, size);
+    return 0;
+  }
+  return size;
 }
 
 bool StorageComponent::write_file_direct(const std::string &path, const std::vector<uint8_t> &data) {
+  LockGuard guard(this->io_mutex_);
   if (!this->sd_component_) {
     ESP_LOGE(TAG, "SD component not available");
     return false;
   }
   
+  // Le handle de lecture et le cache pourraient contenir une version périmée du fichier
+  if (this->read_handle_ != nullptr && this->read_handle_path_ == path) {
+    this->close_read_handle();
+  }
+  auto it = this->files_.find(path);
+  if (it != this->files_.end()) {
+    this->block_cache_.invalidate(it->second.id);
+    it->second.has_metadata = false;
+  }
+  
   this->sd_component_->write_file(path.c_str(), data.data(), data.size());
   return true;
 }
 
+bool StorageComponent::read_range(const std::string &path, size_t offset, size_t length, uint8_t *dst) {
+  if (dst == nullptr || length == 0) {
+    return false;
+  }
+  LockGuard guard(this->io_mutex_);
+  if (!this->sd_component_) {
+    ESP_LOGE(TAG, "SD component not available");
+    return false;
+  }
+  
+  if (this->is_cacheable(length)) {
+    return this->read_range_cached(path, offset, length, dst);
+  }
+  
+  size_t read = this->read_at(path, offset, length, dst);
+  if (read != length) {
+    ESP_LOGW(TAG, "Short read on %s: %zu/%zu bytes at offset %zu", path.c_str(), read, length, offset);
+    return false;
+  }
+  return true;
+}
+
+size_t StorageComponent::read_at(const std::string &path, size_t offset, size_t length, uint8_t *dst) {
+  // Réutiliser le fichier ouvert si c'est le même: évite un lookup FAT par appel
+  if (this->read_handle_ == nullptr || this->read_handle_path_ != path) {
+    this->close_read_handle();
+    std::string full_path = this->build_full_path(path);
+    this->read_handle_ = fopen(full_path.c_str(), "rb");
+    if (this->read_handle_ == nullptr) {
+      ESP_LOGE(TAG, "Failed to open file: %s", full_path.c_str());
+      return 0;
+    }
+    this->read_handle_path_ = path;
+  }
+  
+  if (fseek(this->read_handle_, static_cast<long>(offset), SEEK_SET) != 0) {
+    ESP_LOGE(TAG, "Failed to seek to offset %zu in %s", offset, path.c_str());
+    this->close_read_handle();
+    return 0;
+  }
+  
+  size_t read = fread(dst, 1, length, this->read_handle_);
+  this->bytes_read_ += read;
+  return read;
+}
+
+// Les lectures plus grandes que la moitié du cache (bandes de streaming d'une
+// grande image) le videraient sans jamais y être relues: elles le contournent
+bool StorageComponent::is_cacheable(size_t length) const {
+  return this->block_cache_.is_enabled() && length <= this->block_cache_.get_capacity() / 2;
+}
+
+StorageComponent::FileEntry &StorageComponent::get_file_entry(const std::string &path) {
+  auto it = this->files_.find(path);
+  if (it != this->files_.end()) {
+    return it->second;
+  }
+  FileEntry entry;
+  entry.id = this->next_file_id_++;
+  return this->files_.emplace(path, entry).first->second;
+}
+
+// Taille et date du fichier, depuis le cache si possible: un seul lookup FAT
+// par fichier tant qu'il n'est pas réécrit par write_file_direct(). Lues par
+// stat() sur le VFS, comme les données (voir read_at())
+const StorageComponent::FileEntry &StorageComponent::get_metadata(const std::string &path) {
+  FileEntry &entry = this->get_file_entry(path);
+  if (entry.has_metadata) {
+    this->metadata_hits_++;
+    return entry;
+  }
+  
+  this->metadata_misses_++;
+  struct stat st;
+  std::string full_path = this->build_full_path(path);
+  if (stat(full_path.c_str(), &st) == 0) {
+    entry.size = static_cast<size_t>(st.st_size);
+    entry.mtime = st.st_mtime;
+  } else {
+    entry.size = 0;
+    entry.mtime = 0;
+  }
+  // Un fichier absent n'est pas mis en cache: il peut apparaître plus tard
+  entry.has_metadata = entry.size > 0;
+  return entry;
+}
+
+void StorageComponent::invalidate_metadata() {
+  LockGuard guard(this->io_mutex_);
+  for (auto &file : this->files_) {
+    file.second.has_metadata = false;
+  }
+  // Les blocs en cache et le fichier ouvert peuvent venir de l'ancienne carte
+  this->block_cache_.clear();
+  this->close_read_handle();
+}
+
+time_t StorageComponent::get_file_mtime(const std::string &path) {
+  LockGuard guard(this->io_mutex_);
+  if (!this->sd_component_) {
+    ESP_LOGE(TAG, "SD component not available");
+    return 0;
+  }
+  
+  return this->get_metadata(path).mtime;
+}
+
+bool StorageComponent::read_range_cached(const std::string &path, size_t offset, size_t length, uint8_t *dst) {
+  const size_t block_size = BlockCache::BLOCK_SIZE;
+  uint32_t file_id = this->get_file_entry(path).id;
+  size_t end = offset + length;
+  uint32_t last = (end - 1) / block_size;
+  
+  // Copie la partie utile d'un bloc dans dst; échoue si le fichier est trop court
+  auto copy_block = [&](uint32_t block, const uint8_t *data, size_t block_length) {
+    size_t block_start = static_cast<size_t>(block) * block_size;
+    size_t from = std::max(offset, block_start);
+    size_t to = std::min(end, block_start + block_size);
+    if (block_start + block_length < to) {
+      return false;
+    }
+    memcpy(dst + (from - offset), data + (from - block_start), to - from);
+    return true;
+  };
+  
+  uint32_t block = offset / block_size;
+  while (block <= last) {
+    size_t block_length = 0;
+    const uint8_t *data = this->block_cache_.lookup(file_id, block, block_length);
+    if (data != nullptr) {
+      if (!copy_block(block, data, block_length)) {
+        ESP_LOGW(TAG, "Short read on %s: %zu bytes at offset %zu", path.c_str(), length, offset);
+        return false;
+      }
+      block++;
+      continue;
+    }
+    
+    // Lire d'un seul fread toute la suite de blocs absents
+    uint32_t run_end = block + 1;
+    while (run_end <= last && !this->block_cache_.contains(file_id, run_end)) {
+      run_end++;
+    }
+    size_t run_length = static_cast<size_t>(run_end - block) * block_size;
+    this->block_scratch_.resize(run_length);
+    size_t read = this->read_at(path, static_cast<size_t>(block) * block_size, run_length, this->block_scratch_.data());
+
+    for (size_t run_offset = 0; block < run_end; block++, run_offset += block_size) {
+      const uint8_t *run_data = this->block_scratch_.data() + run_offset;
+      size_t available = read > run_offset ? std::min(read - run_offset, block_size) : 0;
+      if (!copy_block(block, run_data, available)) {
+        ESP_LOGW(TAG, "Short read on %s: %zu bytes at offset %zu", path.c_str(), length, offset);
+        return false;
+      }
+      this->block_cache_.insert(file_id, block, run_data, available);
+    }
+  }
+  return true;
+}
+
+std::string StorageComponent::build_full_path(const std::string &path) const {
+  if (this->root_path_.empty() || this->root_path_ == "/") {
+    return path;
+  }
+  if (path.compare(0, this->root_path_.size(), this->root_path_) == 0) {
+    return path;
+  }
+  if (this->root_path_.back() == '/' && !path.empty() && path[0] == '/') {
+    return this->root_path_ + path.substr(1);
+  }
+  return this->root_path_ + path;
+}
+
+void StorageComponent::close_read_handle() {
+  if (this->read_handle_ != nullptr) {
+    fclose(this->read_handle_);
+    this->read_handle_ = nullptr;
+  }
+  this->read_handle_path_.clear();
+}
+
 size_t StorageComponent::get_file_size(const std::string &path) {
+  LockGuard guard(this->io_mutex_);
   if (!this->sd_component_) {
     ESP_LOGE(TAG, "SD component not available");
     return 0;
   }
   
-  return this->sd_component_->file_size(path);
+  return this->get_metadata(path).size;
 }
 
 // ======== SdImageComponent Implementation ========
@@ -87,153 +554,946 @@ void SdImageComponent::setup() {
     return;
   }
   
-  if (!this->validate_dimensions()) {
-    ESP_LOGE(TAG_IMAGE, "Invalid image dimensions: %dx%d", this->width_, this->height_);
-    this->mark_failed();
-    return;
+  if (!this->validate_file_path()) {
+    ESP_LOGE(TAG_IMAGE, "Invalid file path: %s", this->file_path_.c_str());
+    this->mark_failed();
+    return;
+  }
+  
+  // Dimensions non configurées: les lire dans l'en-tête JPEG/PNG du fichier
+  if (!this->has_valid_dimensions()) {
+    int width, height;
+    if (this->probe_image_dimensions(this->file_path_, this->make_load_request(), width, height)) {
+      this->width_ = width;
+      this->height_ = height;
+    }
+  }
+  
+  if (!this->validate_dimensions()) {
+    ESP_LOGE(TAG_IMAGE, "Invalid image dimensions: %dx%d", this->width_, this->height_);
+    this->mark_failed();
+    return;
+  }
+  
+  // Calculer la taille attendue
+  this->expected_data_size_ = this->calculate_expected_size();
+  
+  // Vérifier si le fichier existe sur la SD
+  if (!this->storage_component_->file_exists_direct(this->file_path_)) {
+    ESP_LOGW(TAG_IMAGE, "Image file does not exist: %s", this->file_path_.c_str());
+  } else {
+    ESP_LOGI(TAG_IMAGE, "Image file found: %s", this->file_path_.c_str());
+  }
+  
+  // Précharger l'image si demandé
+  if (this->preload_) {
+    if (this->load_image()) {
+      ESP_LOGI(TAG_IMAGE, "Image preloaded successfully");
+    } else {
+      ESP_LOGW(TAG_IMAGE, "Failed to preload image");
+    }
+  }
+  
+  ESP_LOGCONFIG(TAG_IMAGE, "SD Image Component setup complete");
+}
+
+void SdImageComponent::dump_config() {
+  ESP_LOGCONFIG(TAG_IMAGE, "SD Image:");
+  ESP_LOGCONFIG(TAG_IMAGE, "  File Path: %s", this->file_path_.c_str());
+  ESP_LOGCONFIG(TAG_IMAGE, "  Dimensions: %dx%d", this->width_, this->height_);
+  ESP_LOGCONFIG(TAG_IMAGE, "  Format: %s", this->get_format_string().c_str());
+  ESP_LOGCONFIG(TAG_IMAGE, "  Byte Order: %s", 
+                this->byte_order_ == ByteOrder::little_endian ? "Little Endian" : "Big Endian");
+  ESP_LOGCONFIG(TAG_IMAGE, "  Expected Size: %zu bytes", this->expected_data_size_);
+  if (this->payload_offset_ > 0) {
+    ESP_LOGCONFIG(TAG_IMAGE, "  Container: %s pixels at offset %zu (%zu bytes), %zu bytes per row%s",
+                  this->compression_ == PayloadCompression::rle ? "RLE" : "raw", this->payload_offset_,
+                  this->payload_size_, this->get_row_stride(), this->row_index_offset_ > 0 ? ", row index" : "");
+  }
+  if (this->format_ == ImageFormat::indexed) {
+    ESP_LOGCONFIG(TAG_IMAGE, "  Palette: %u-bit indices%s", this->index_bits_,
+                  this->palette_has_alpha_ ? ", with transparency" : "");
+  }
+  ESP_LOGCONFIG(TAG_IMAGE, "  Cache Enabled: %s", this->cache_enabled_ ? "YES" : "NO");
+  ESP_LOGCONFIG(TAG_IMAGE, "  Preload: %s", this->preload_ ? "YES" : "NO");
+  ESP_LOGCONFIG(TAG_IMAGE, "  Double Buffer: %s", this->double_buffer_ ? "YES" : "NO");
+  if (this->double_buffer_) {
+    ESP_LOGCONFIG(TAG_IMAGE, "    Peak Memory During Swap: %zu bytes", this->double_buffer_peak_bytes_);
+    ESP_LOGCONFIG(TAG_IMAGE, "    Last Swap: %u us", (unsigned) this->last_swap_time_us_);
+  }
+  if (!this->cache_enabled_) {
+    ESP_LOGCONFIG(TAG_IMAGE, "  Stream Band Height: %d rows", this->stream_band_height_);
+    ESP_LOGCONFIG(TAG_IMAGE, "  Stream Peak RAM: %zu bytes", this->get_stream_buffer_size());
+  }
+  ESP_LOGCONFIG(TAG_IMAGE, "  Currently Loaded: %s", this->is_loaded_ ? "YES" : "NO");
+  
+  ImageMemoryManager *memory = ImageMemoryManager::get_instance();
+  ESP_LOGCONFIG(TAG_IMAGE, "  Shared Memory Budget: %zu/%zu bytes resident (%zu images), %u evictions, %u reloads",
+                memory->get_resident_bytes(), memory->get_budget(), memory->get_image_count(),
+                (unsigned) memory->get_evictions(), (unsigned) memory->get_reloads());
+  ESP_LOGCONFIG(TAG_IMAGE, "  Buffer Placement: %s", buffer_placement_to_string(this->buffer_placement_));
+  for (BufferRegion region : {BufferRegion::internal, BufferRegion::psram}) {
+    const RegionUsage &usage = ImageBuffer::get_usage(region);
+    ESP_LOGCONFIG(TAG_IMAGE, "    %s: %zu bytes in use, peak %zu, %u allocations, %u failures",
+                  ImageBuffer::region_to_string(region), usage.in_use.load(), usage.peak.load(),
+                  (unsigned) usage.allocations.load(), (unsigned) usage.failures.load());
+  }
+  
+  if (this->is_loaded_) {
+    ESP_LOGCONFIG(TAG_IMAGE, "  Memory Usage: %zu bytes (%s)", this->get_memory_usage(),
+                  ImageBuffer::region_to_string(this->image_data_.get_region()));
+    ESP_LOGCONFIG(TAG_IMAGE, "  Last Load: %u ms, %zu bytes read, peak %zu bytes, %u SD lookups saved",
+                  (unsigned) this->last_load_time_ms_, this->last_load_bytes_read_, this->last_load_peak_bytes_,
+                  (unsigned) this->last_load_saved_sd_ops_);
+    if (this->heap_low_water_after_ > 0) {
+      ESP_LOGCONFIG(TAG_IMAGE, "  Internal Heap Low-Water: %zu bytes before load, %zu after",
+                    this->heap_low_water_before_, this->heap_low_water_after_);
+    }
+  }
+}
+
+void SdImageComponent::set_format_string(const std::string &format) {
+  if (format == "RGB565") this->format_ = ImageFormat::rgb565;
+  else if (format == "RGB888") this->format_ = ImageFormat::rgb888;
+  else if (format == "RGBA") this->format_ = ImageFormat::rgba;
+  else if (format == "GRAYSCALE") this->format_ = ImageFormat::grayscale;  // Fixed spelling
+  else if (format == "BINARY") this->format_ = ImageFormat::binary;
+  else {
+    ESP_LOGW(TAG_IMAGE, "Unknown format: %s, using RGB565", format.c_str());
+    this->format_ = ImageFormat::rgb565; // default
+  }
+  this->raw_format_ = this->format_;
+}
+
+void SdImageComponent::set_output_format_string(const std::string &format) {
+  if (format == "RGB565") this->output_format_ = OutputImageFormat::rgb565;
+  else if (format == "RGB888") this->output_format_ = OutputImageFormat::rgb888;
+  else if (format == "RGBA") this->output_format_ = OutputImageFormat::rgba;
+  else {
+    ESP_LOGW(TAG_IMAGE, "Unknown output format: %s, using RGB565", format.c_str());
+    this->output_format_ = OutputImageFormat::rgb565; // default
+  }
+}
+
+std::string SdImageComponent::get_output_format_string() const {
+  switch (this->output_format_) {
+    case OutputImageFormat::rgb565: return "RGB565";
+    case OutputImageFormat::rgb888: return "RGB888";
+    case OutputImageFormat::rgba: return "RGBA";
+    default: return "Unknown";
+  }
+}
+
+void SdImageComponent::set_byte_order_string(const std::string &byte_order) {
+  if (byte_order == "BIG_ENDIAN") this->byte_order_ = ByteOrder::big_endian;
+  else if (byte_order == "LITTLE_ENDIAN") this->byte_order_ = ByteOrder::little_endian;
+  else {
+    ESP_LOGW(TAG_IMAGE, "Unknown byte order: %s, using little_endian", byte_order.c_str());
+    this->byte_order_ = ByteOrder::little_endian; // default
+  }
+}
+
+bool SdImageComponent::load_image() {
+  return this->load_image_from_path(this->file_path_);
+}
+
+bool SdImageComponent::load_image_from_path(const std::string &path) {
+  return this->load_image_from_path(path, nullptr, 0);
+}
+
+// Avec un buffer fourni, les pixels y sont écrits directement (aucune
+// allocation): il doit rester valide tant que l'image est chargée
+bool SdImageComponent::load_image_from_path(const std::string &path, uint8_t *buffer, size_t capacity) {
+  ESP_LOGD(TAG_IMAGE, "Loading image from: %s", path.c_str());
+  
+  if (!this->storage_component_) {
+    ESP_LOGE(TAG_IMAGE, "Storage component not available");
+    return false;
+  }
+  
+  // La tâche de fond installera son image au prochain loop(): un chargement
+  // synchrone maintenant serait aussitôt remplacé
+  if (this->is_load_pending()) {
+    ESP_LOGW(TAG_IMAGE, "Async load in progress, not loading: %s", path.c_str());
+    return false;
+  }
+  
+  // Libérer l'image précédente si chargée; en double buffer elle reste
+  // affichable jusqu'à l'échange et intacte si le chargement échoue
+  if (this->is_loaded_ && !this->double_buffer_) {
+    this->unload_image();
+  }
+  
+  LoadedImage image;
+  image.request = this->make_load_request();
+  image.data.wrap(buffer, capacity);
+  if (!this->read_image(path, image)) {
+    this->load_error_callback_.call();
+    return false;
+  }
+  
+  this->apply_image(std::move(image));
+  this->load_complete_callback_.call();
+  return true;
+}
+
+// Lecture + décodage complets d'une image, sans modifier l'image affichée:
+// peut tourner sur une tâche de fond (voir load_image_async())
+bool SdImageComponent::read_image(const std::string &path, LoadedImage &image) const {
+  const LoadRequest &request = image.request;
+  uint32_t metadata_hits = this->storage_component_->get_metadata_hits();
+  image.heap_low_water_before = get_internal_heap_low_water();
+  image.data.set_placement(request.placement);
+  
+  // Vérifier si le fichier existe
+  if (!this->storage_component_->file_exists_direct(path)) {
+    ESP_LOGE(TAG_IMAGE, "Image file not found: %s", path.c_str());
+    return false;
+  }
+  
+  uint32_t start = millis();
+  size_t bytes_read = this->storage_component_->get_bytes_read();
+  image.path = path;
+  
+  // Détection JPEG/PNG par les octets magiques, sans lire tout le fichier
+  std::vector<uint8_t> header(8);
+  bool header_ok = this->storage_component_->read_range(path, 0, header.size(), header.data());
+  bool is_jpeg = header_ok && this->is_jpeg_file(header);
+  bool is_png = header_ok && this->is_png_file(header);
+  bool is_asset = header_ok && ImageAssetHeader::has_magic(header.data(), header.size());
+  ImageAssetHeader asset;
+  if (is_asset && !this->read_asset_header(path, asset)) {
+    ESP_LOGE(TAG_IMAGE, "Invalid image container: %s", path.c_str());
+    return false;
+  }
+  
+  // Mode streaming: rien n'est lu ici, draw() lira l'image par bandes
+  // (fichiers bruts) ou la décodera ligne par ligne (PNG)
+  if (!request.cache_enabled && !is_jpeg) {
+    image.streaming = true;
+    if (is_png) {
+      PngStreamDecoder decoder(this->make_storage_reader(path));
+      if (!decoder.read_header()) {
+        ESP_LOGE(TAG_IMAGE, "Invalid PNG file: %s", path.c_str());
+        return false;
+      }
+      image.width = decoder.get_width();
+      image.height = decoder.get_height();
+      image.format = get_decoded_format(request.output_format);
+      image.stream_png = true;
+    } else if (is_asset) {
+      if (!this->apply_asset_header(path, asset, image)) {
+        return false;
+      }
+    } else {
+      image.width = request.width;
+      image.height = request.height;
+      image.format = request.raw_format;
+      image.byte_order = request.byte_order;
+      size_t file_size = this->storage_component_->get_file_size(path);
+      if (request.expected_size > 0 && file_size != request.expected_size) {
+        ESP_LOGW(TAG_IMAGE, "Image size mismatch. Expected: %zu, Got: %zu", 
+                 request.expected_size, file_size);
+      }
+    }
+    image.load_time_ms = millis() - start;
+    image.bytes_read = this->storage_component_->get_bytes_read() - bytes_read;
+    image.saved_sd_ops = this->storage_component_->get_metadata_hits() - metadata_hits;
+    return true;
+  }
+  
+  // Image identique déjà décodée par un autre composant: partager son buffer
+  std::string share_key = this->get_share_key(path, is_jpeg || is_png, request);
+  if (!image.data.is_external() && ImageRegistry::get_instance()->acquire(share_key, image)) {
+    image.load_time_ms = millis() - start;
+    image.saved_sd_ops = this->storage_component_->get_metadata_hits() - metadata_hits;
+    image.heap_low_water_after = get_internal_heap_low_water();
+    return true;
+  }
+  
+  // Connaître la taille réelle avant toute allocation
+  if (is_jpeg || is_png) {
+    int width, height;
+    if (!this->probe_image_dimensions(path, request, width, height)) {
+      ESP_LOGE(TAG_IMAGE, "Invalid image header: %s", path.c_str());
+      return false;
+    }
+    if (width > MAX_IMAGE_WIDTH || height > MAX_IMAGE_HEIGHT) {
+      ESP_LOGE(TAG_IMAGE, "Image too large: %dx%d", width, height);
+      return false;
+    }
+  }
+  
+  bool ok;
+  if (is_png) {
+    // Le PNG est lu par petits morceaux: le fichier compressé n'est jamais entier en RAM
+    PngStreamDecoder decoder(this->make_storage_reader(path));
+    ok = this->decode_png_stream(decoder, image);
+    image.peak_bytes = decoder.get_memory_usage() + image.data.size();
+  } else if (is_jpeg) {
+    std::vector<uint8_t> data = this->storage_component_->read_file_direct(path);
+    if (data.empty()) {
+      ESP_LOGE(TAG_IMAGE, "Failed to read image file: %s", path.c_str());
+      return false;
+    }
+    if (!request.cache_enabled) {
+      ESP_LOGW(TAG_IMAGE, "JPEG images cannot be streamed, decoding into RAM");
+    }
+    // Le fichier compressé et l'image décodée coexistent pendant le décodage
+    ok = this->decode_jpeg(data, image);
+    image.peak_bytes = data.size() + image.data.size();
+  } else if (is_asset) {
+    ok = this->load_asset_data(path, asset, image);
+    image.peak_bytes = image.data.size() + (asset.is_compressed() ? sizeof(RleRowDecoder) : 0);
+  } else {
+    // Fichier brut: lu directement dans le buffer final
+    ok = this->load_raw_data(path, image);
+    image.peak_bytes = image.data.size();
+  }
+  
+  if (!ok) {
+    ESP_LOGE(TAG_IMAGE, "Failed to decode image file: %s", path.c_str());
+    return false;
+  }
+  
+  if (!image.data.is_external()) {
+    ImageRegistry::get_instance()->publish(share_key, image);
+  }
+  
+  image.load_time_ms = millis() - start;
+  image.bytes_read = this->storage_component_->get_bytes_read() - bytes_read;
+  image.saved_sd_ops = this->storage_component_->get_metadata_hits() - metadata_hits;
+  image.heap_low_water_after = get_internal_heap_low_water();
+  return true;
+}
+
+// Clé de partage: tout ce qui change le contenu du buffer décodé. La date du
+// fichier évite de resservir une version périmée après une réécriture.
+std::string SdImageComponent::get_share_key(const std::string &path, bool decoded,
+                                            const LoadRequest &request) const {
+  char buffer[96];
+  if (decoded) {
+    snprintf(buffer, sizeof(buffer), "|dec:%d:%dx%d|%ld", static_cast<int>(request.output_format),
+             request.width_override, request.height_override,
+             static_cast<long>(this->storage_component_->get_file_mtime(path)));
+  } else {
+    snprintf(buffer, sizeof(buffer), "|raw:%d:%dx%d:%d|%ld", static_cast<int>(request.raw_format), request.width,
+             request.height, static_cast<int>(request.byte_order),
+             static_cast<long>(this->storage_component_->get_file_mtime(path)));
+  }
+  return path + buffer;
+}
+
+std::string SdImageComponent::get_debug_info() const {
+  char buffer[320];
+  snprintf(buffer, sizeof(buffer),
+           "SdImage[%s]: %dx%d, %s, loaded=%s, size=%zu bytes, shared by %ld, last draw=%u us "
+           "(%zu bytes read), dedup saved %zu bytes",
+           this->file_path_.c_str(), this->width_, this->height_, this->get_output_format_string().c_str(),
+           this->is_loaded_ ? "yes" : "no", this->image_data_.size(), this->image_data_.get_share_count(),
+           (unsigned) this->last_draw_time_us_, this->last_draw_bytes_read_,
+           ImageRegistry::get_instance()->get_bytes_saved());
+  return std::string(buffer);
+}
+
+LoadRequest SdImageComponent::make_load_request() const {
+  LoadRequest request;
+  request.width = this->width_;
+  request.height = this->height_;
+  request.width_override = this->width_override_;
+  request.height_override = this->height_override_;
+  request.raw_format = this->raw_format_;
+  request.byte_order = this->byte_order_;
+  request.output_format = this->output_format_;
+  request.cache_enabled = this->cache_enabled_;
+  request.placement = this->buffer_placement_;
+  request.expected_size = this->expected_data_size_;
+  return request;
+}
+
+// Installe une image préparée par read_image(): uniquement des échanges de
+// buffers, aucune lecture SD ni décodage
+void SdImageComponent::apply_image(LoadedImage &&image) {
+  uint32_t start = micros();
+  if (this->double_buffer_) {
+    // Les deux buffers coexistent jusqu'ici: c'est le coût mémoire du double buffer
+    this->double_buffer_peak_bytes_ =
+        std::max(this->double_buffer_peak_bytes_, this->image_data_.size() + image.data.size());
+  }
+  
+  // Échange de pointeurs: l'ancien buffer part avec `image` et est libéré par l'appelant
+  this->image_data_.swap(image.data);
+  this->width_ = image.width;
+  this->height_ = image.height;
+  this->format_ = image.format;
+  this->row_stride_ = image.row_stride;
+  this->payload_offset_ = image.payload_offset;
+  this->payload_size_ = image.payload_size;
+  this->row_index_offset_ = image.row_index_offset;
+  this->compression_ = image.compression;
+  this->stream_byte_order_ = image.byte_order;
+  this->index_bits_ = image.index_bits;
+  this->chroma_key_ = image.chroma_key;
+  this->reset_pixel_row();
+  this->build_palette(image.palette);
+  this->streaming_mode_ = image.streaming;
+  this->stream_png_ = image.stream_png;
+  this->last_load_time_ms_ = image.load_time_ms;
+  this->last_load_peak_bytes_ = image.peak_bytes;
+  this->last_load_bytes_read_ = image.bytes_read;
+  this->last_load_saved_sd_ops_ = image.saved_sd_ops;
+  this->heap_low_water_before_ = image.heap_low_water_before;
+  this->heap_low_water_after_ = image.heap_low_water_after;
+  this->file_path_ = std::move(image.path);
+  this->expected_data_size_ = this->calculate_expected_size();
+  this->is_loaded_ = true;
+  this->last_swap_time_us_ = micros() - start;
+  
+  if (this->streaming_mode_) {
+    ESP_LOGD(TAG_IMAGE, "Image loaded in streaming mode (%zu bytes scratch)", this->get_stream_buffer_size());
+  } else {
+    ESP_LOGD(TAG_IMAGE, "Image loaded and cached: %zu bytes in %u ms (%zu bytes read, peak %zu bytes)",
+             this->image_data_.size(), (unsigned) this->last_load_time_ms_, this->last_load_bytes_read_,
+             this->last_load_peak_bytes_);
+  }
+  
+  // Seuls les buffers possédés par le composant comptent dans le budget partagé
+  this->evicted_ = false;
+  ImageMemoryManager *memory = ImageMemoryManager::get_instance();
+  if (this->streaming_mode_ || this->image_data_.empty() || this->image_data_.is_external()) {
+    memory->on_unloaded(this);
+  } else {
+    memory->on_loaded(this, this->image_data_.data(), this->image_data_.capacity());
+  }
+}
+
+// ======== Chargement asynchrone ========
+
+bool SdImageComponent::load_image_async(const std::string &path) {
+  if (!this->storage_component_) {
+    ESP_LOGE(TAG_IMAGE, "Storage component not available");
+    return false;
+  }
+  
+  // Un seul chargement à la fois: le dernier chemin demandé est mis en attente
+  if (this->load_state_.load() != LOAD_IDLE) {
+    ESP_LOGD(TAG_IMAGE, "Load in progress, queueing: %s", path.c_str());
+    this->queued_path_ = path;
+    return true;
+  }
+  
+  this->pending_path_ = path;
+  this->pending_image_.reset(new LoadedImage());
+  this->pending_image_->request = this->make_load_request();
+  this->load_state_.store(LOAD_RUNNING);
+  
+#if defined(USE_ESP32)
+  if (xTaskCreate(SdImageComponent::load_task, "sd_image_load", LOAD_TASK_STACK_SIZE, this, 1, nullptr) != pdPASS) {
+    ESP_LOGE(TAG_IMAGE, "Failed to create load task");
+    this->pending_image_.reset();
+    this->load_state_.store(LOAD_IDLE);
+    return false;
+  }
+#elif defined(USE_HOST)
+  std::thread(SdImageComponent::load_task, this).detach();
+#else
+  // Pas de tâche de fond disponible: chargement immédiat, publié au prochain loop()
+  SdImageComponent::load_task(this);
+#endif
+  return true;
+}
+
+void SdImageComponent::load_task(void *arg) {
+  auto *self = static_cast<SdImageComponent *>(arg);
+  bool ok = self->read_image(self->pending_path_, *self->pending_image_);
+  // Publication: loop() ne lit pending_image_ qu'après avoir vu cet état
+  self->load_state_.store(ok ? LOAD_DONE : LOAD_FAILED);
+#ifdef USE_ESP32
+  vTaskDelete(nullptr);
+#endif
+}
+
+void SdImageComponent::loop() {
+  uint32_t now = millis();
+  if (now - this->last_draw_stats_time_ >= DRAW_STATS_INTERVAL_MS) {
+    this->last_draw_stats_time_ = now;
+    this->log_draw_stats();
+  }
+  
+  uint8_t state = this->load_state_.load();
+  if (state == LOAD_IDLE || state == LOAD_RUNNING) {
+    return;
+  }
+  
+  std::unique_ptr<LoadedImage> image = std::move(this->pending_image_);
+  this->load_state_.store(LOAD_IDLE);
+  
+  if (state == LOAD_DONE) {
+    this->apply_image(std::move(*image));
+    this->load_complete_callback_.call();
+  } else {
+    ESP_LOGE(TAG_IMAGE, "Async load failed: %s", this->pending_path_.c_str());
+    this->load_error_callback_.call();
+  }
+  
+  if (!this->queued_path_.empty()) {
+    std::string next = std::move(this->queued_path_);
+    this->queued_path_.clear();
+    this->load_image_async(next);
+  }
+}
+
+bool SdImageComponent::load_raw_data(const std::string &path, LoadedImage &image) const {
+  const LoadRequest &request = image.request;
+  image.width = request.width;
+  image.height = request.height;
+  image.format = request.raw_format;
+  
+  size_t file_size = this->storage_component_->get_file_size(path);
+  
+  // Vérifier la taille des données
+  if (request.expected_size > 0 && file_size != request.expected_size) {
+    ESP_LOGW(TAG_IMAGE, "Image size mismatch. Expected: %zu, Got: %zu", 
+             request.expected_size, file_size);
+    // Continuer quand même, mais avec avertissement
+  }
+  
+  // Lire directement dans le buffer final: pas de vector intermédiaire
+  if (file_size == 0 || !image.data.allocate(file_size)) {
+    return false;
+  }
+  if (this->storage_component_->read_file_into(path, image.data.data(), file_size) != file_size) {
+    ESP_LOGE(TAG_IMAGE, "Failed to read image file: %s", path.c_str());
+    return false;
+  }
+  
+  // Conversion de l'ordre des bytes si nécessaire
+  size_t pixel_size = get_format_pixel_size(image.format);
+  if (request.byte_order == ByteOrder::big_endian && pixel_size > 1) {
+    swap_byte_order(image.data.data(), image.data.size(), pixel_size);
+  }
+  
+  return true;
+}
+
+bool SdImageComponent::read_asset_header(const std::string &path, ImageAssetHeader &header) const {
+  uint8_t data[ImageAssetHeader::SIZE];
+  return this->storage_component_->read_range(path, 0, sizeof(data), data) && header.parse(data, sizeof(data));
+}
+
+bool SdImageComponent::apply_asset_header(const std::string &path, const ImageAssetHeader &header,
+                                          LoadedImage &image) const {
+  if (header.width > MAX_IMAGE_WIDTH || header.height > MAX_IMAGE_HEIGHT) {
+    ESP_LOGE(TAG_IMAGE, "Image too large: %dx%d", header.width, header.height);
+    return false;
+  }
+  
+  image.width = header.width;
+  image.height = header.height;
+  image.format = header.format;
+  image.byte_order = header.byte_order;
+  image.payload_offset = header.payload_offset;
+  image.payload_size = header.payload_size;
+  image.compression = header.compression;
+  image.row_index_offset = header.has_row_index() ? header.row_index_offset : 0;
+  image.chroma_key = header.alpha_mode == AlphaMode::chroma_key;
+  // Lignes contiguës: inutile de garder le pas
+  image.row_stride = header.row_stride == header.get_min_row_stride() ? 0 : header.row_stride;
+  if (header.has_palette()) {
+    // Indices plus petits qu'un octet: le pas reste nécessaire
+    image.row_stride = header.row_stride;
+    image.index_bits = header.index_bits;
+    image.palette.resize(4 * header.palette_size);
+    if (!this->storage_component_->read_range(path, header.palette_offset, image.palette.size(),
+                                              image.palette.data())) {
+      ESP_LOGE(TAG_IMAGE, "Failed to read image palette: %s", path.c_str());
+      return false;
+    }
+  }
+  ESP_LOGV(TAG_IMAGE, "Image container v%u: %dx%d, %s, %s, stride %zu, %zu bytes at offset %zu", header.version,
+           header.width, header.height, header.is_compressed() ? "RLE" : "uncompressed",
+           header.has_crc() ? "CRC" : "no CRC", header.row_stride, header.payload_size, header.payload_offset);
+  return true;
+}
+
+// Pixels lus à partir de leur offset aligné directement dans le buffer
+// final (décompressés au fil de la lecture, sans copie du payload
+// compressé en RAM), puis vérifiés par le CRC de l'en-tête s'il est présent
+bool SdImageComponent::load_asset_data(const std::string &path, const ImageAssetHeader &header,
+                                       LoadedImage &image) const {
+  if (!this->apply_asset_header(path, header, image)) {
+    return false;
+  }
+  
+  if (header.is_compressed()) {
+    size_t row_size = header.row_stride;
+    if (!image.data.allocate(row_size * header.height)) {
+      return false;
+    }
+    RleRowDecoder decoder(this->make_storage_reader(path), header.payload_offset, header.payload_size,
+                          get_format_pixel_size(header.format), row_size);
+    for (int y = 0; y < header.height; y++) {
+      if (!decoder.decode_row(image.data.data() + y * row_size)) {
+        ESP_LOGE(TAG_IMAGE, "Corrupt compressed image at row %d: %s", y, path.c_str());
+        return false;
+      }
+    }
+  } else {
+    if (!image.data.allocate(header.payload_size)) {
+      return false;
+    }
+    if (!this->storage_component_->read_range(path, header.payload_offset, header.payload_size,
+                                              image.data.data())) {
+      ESP_LOGE(TAG_IMAGE, "Failed to read image payload: %s", path.c_str());
+      return false;
+    }
+  }
+  
+  if (header.has_crc()) {
+    uint32_t crc = crc32_le(image.data.data(), image.data.size());
+    if (crc != header.crc32) {
+      ESP_LOGE(TAG_IMAGE, "Image payload CRC mismatch: %08X, expected %08X", (unsigned) crc,
+               (unsigned) header.crc32);
+      return false;
+    }
+  }
+  
+  size_t pixel_size = get_format_pixel_size(image.format);
+  if (image.byte_order == ByteOrder::big_endian && pixel_size > 1) {
+    swap_byte_order(image.data.data(), image.data.size(), pixel_size);
+  }
+  image.byte_order = ByteOrder::little_endian;
+  return true;
+}
+
+// ======== Décodage JPEG/PNG ========
+
+bool SdImageComponent::is_jpeg_file(const std::vector<uint8_t> &data) const {
+  return data.size() >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+bool SdImageComponent::is_png_file(const std::vector<uint8_t> &data) const {
+  static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+  return data.size() >= sizeof(PNG_SIGNATURE) && memcmp(data.data(), PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) == 0;
+}
+
+bool SdImageComponent::extract_jpeg_dimensions(const std::vector<uint8_t> &data, int &width, int &height) const {
+  size_t i = 2;
+  while (i + 9 <= data.size()) {
+    if (data[i] != 0xFF) {
+      i++;
+      continue;
+    }
+    uint8_t marker = data[i + 1];
+    if (marker == 0xFF) {
+      // Octet de remplissage
+      i++;
+      continue;
+    }
+    // SOF0..SOF15, sauf DHT (C4), JPG (C8) et DAC (CC)
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+      height = (data[i + 5] << 8) | data[i + 6];
+      width = (data[i + 7] << 8) | data[i + 8];
+      return width > 0 && height > 0;
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      // Fin d'image ou début des données sans SOF
+      return false;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      i += 2;
+      continue;
+    }
+    i += 2 + ((data[i + 2] << 8) | data[i + 3]);
+  }
+  return false;
+}
+
+bool SdImageComponent::decode_jpeg(const std::vector<uint8_t> &jpeg_data, LoadedImage &image) const {
+#ifdef USE_ESP_IDF
+  int width, height;
+  if (!this->extract_jpeg_dimensions(jpeg_data, width, height)) {
+    ESP_LOGE(TAG_IMAGE, "Invalid JPEG: no frame header found");
+    return false;
+  }
+  
+  // esp_jpeg ne sait produire que du RGB565 ou RGB888; RGBA est étendu après coup
+  ImageFormat format;
+  size_t bytes_per_pixel;
+  esp_jpeg_image_format_t out_format;
+  switch (image.request.output_format) {
+    case OutputImageFormat::rgb888:
+      format = ImageFormat::rgb888;
+      bytes_per_pixel = 3;
+      out_format = JPEG_IMAGE_FORMAT_RGB888;
+      break;
+    case OutputImageFormat::rgba:
+      format = ImageFormat::rgba;
+      bytes_per_pixel = 4;
+      out_format = JPEG_IMAGE_FORMAT_RGB888;
+      break;
+    case OutputImageFormat::rgb565:
+    default:
+      format = ImageFormat::rgb565;
+      bytes_per_pixel = 2;
+      out_format = JPEG_IMAGE_FORMAT_RGB565;
+      break;
+  }
+  
+  // Réduction dans le domaine DCT: l'image est décodée directement à l'échelle
+  // 1/2, 1/4 ou 1/8, sans buffer intermédiaire pleine taille
+  int scale_shift = select_jpeg_scale(width, height, image.request);
+  int divisor = 1 << scale_shift;
+  int scaled_width = (width + divisor - 1) / divisor;
+  int scaled_height = (height + divisor - 1) / divisor;
+  if (scale_shift > 0) {
+    ESP_LOGD(TAG_IMAGE, "JPEG %dx%d decoded at 1/%d scale: %dx%d", width, height, divisor, scaled_width,
+             scaled_height);
   }
   
-  if (!this->validate_file_path()) {
-    ESP_LOGE(TAG_IMAGE, "Invalid file path: %s", this->file_path_.c_str());
-    this->mark_failed();
-    return;
+  if (!image.data.allocate(static_cast<size_t>(scaled_width) * scaled_height * bytes_per_pixel)) {
+    return false;
   }
+  uint8_t *pixels = image.data.data();
   
-  // Calculer la taille attendue
-  this->expected_data_size_ = this->calculate_expected_size();
+  esp_jpeg_image_cfg_t cfg = {};
+  cfg.indata = const_cast<uint8_t *>(jpeg_data.data());
+  cfg.indata_size = jpeg_data.size();
+  cfg.outbuf = pixels;
+  cfg.outbuf_size = image.data.size();
+  cfg.out_format = out_format;
+  cfg.out_scale = static_cast<esp_jpeg_image_scale_t>(JPEG_IMAGE_SCALE_0 + scale_shift);
+  // RGB565 reste little-endian en RAM, comme les fichiers bruts après conversion
+  cfg.flags.swap_color_bytes = 0;
   
-  // Vérifier si le fichier existe sur la SD
-  if (!this->storage_component_->file_exists_direct(this->file_path_)) {
-    ESP_LOGW(TAG_IMAGE, "Image file does not exist: %s", this->file_path_.c_str());
-  } else {
-    ESP_LOGI(TAG_IMAGE, "Image file found: %s", this->file_path_.c_str());
+  esp_jpeg_image_output_t out = {};
+  esp_err_t err = esp_jpeg_decode(&cfg, &out);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG_IMAGE, "JPEG decode failed: %s", esp_err_to_name(err));
+    return false;
   }
   
-  // Précharger l'image si demandé
-  if (this->preload_) {
-    if (this->load_image()) {
-      ESP_LOGI(TAG_IMAGE, "Image preloaded successfully");
-    } else {
-      ESP_LOGW(TAG_IMAGE, "Failed to preload image");
+  if (format == ImageFormat::rgba) {
+    // Étendre RGB888 -> RGBA sur place, en partant de la fin
+    size_t count = static_cast<size_t>(out.width) * out.height;
+    for (size_t i = count; i-- > 0;) {
+      pixels[i * 4 + 3] = 0xFF;
+      pixels[i * 4 + 2] = pixels[i * 3 + 2];
+      pixels[i * 4 + 1] = pixels[i * 3 + 1];
+      pixels[i * 4 + 0] = pixels[i * 3 + 0];
     }
   }
   
-  ESP_LOGCONFIG(TAG_IMAGE, "SD Image Component setup complete");
-}
-
-void SdImageComponent::dump_config() {
-  ESP_LOGCONFIG(TAG_IMAGE, "SD Image:");
-  ESP_LOGCONFIG(TAG_IMAGE, "  File Path: %s", this->file_path_.c_str());
-  ESP_LOGCONFIG(TAG_IMAGE, "  Dimensions: %dx%d", this->width_, this->height_);
-  ESP_LOGCONFIG(TAG_IMAGE, "  Format: %s", this->get_format_string().c_str());
-  ESP_LOGCONFIG(TAG_IMAGE, "  Byte Order: %s", 
-                this->byte_order_ == ByteOrder::little_endian ? "Little Endian" : "Big Endian");
-  ESP_LOGCONFIG(TAG_IMAGE, "  Expected Size: %zu bytes", this->expected_data_size_);
-  ESP_LOGCONFIG(TAG_IMAGE, "  Cache Enabled: %s", this->cache_enabled_ ? "YES" : "NO");
-  ESP_LOGCONFIG(TAG_IMAGE, "  Preload: %s", this->preload_ ? "YES" : "NO");
-  ESP_LOGCONFIG(TAG_IMAGE, "  Currently Loaded: %s", this->is_loaded_ ? "YES" : "NO");
+  image.width = out.width;
+  image.height = out.height;
+  image.format = format;
   
-  if (this->is_loaded_) {
-    ESP_LOGCONFIG(TAG_IMAGE, "  Memory Usage: %zu bytes", this->get_memory_usage());
-  }
+  ESP_LOGD(TAG_IMAGE, "JPEG decoded: %dx%d", out.width, out.height);
+  return true;
+#else
+  ESP_LOGE(TAG_IMAGE, "JPEG decoding requires ESP-IDF (esp_jpeg)");
+  return false;
+#endif
 }
 
-void SdImageComponent::set_format_string(const std::string &format) {
-  if (format == "RGB565") this->format_ = ImageFormat::rgb565;
-  else if (format == "RGB888") this->format_ = ImageFormat::rgb888;
-  else if (format == "RGBA") this->format_ = ImageFormat::rgba;
-  else if (format == "GRAYSCALE") this->format_ = ImageFormat::grayscale;  // Fixed spelling
-  else if (format == "BINARY") this->format_ = ImageFormat::binary;
-  else {
-    ESP_LOGW(TAG_IMAGE, "Unknown format: %s, using RGB565", format.c_str());
-    this->format_ = ImageFormat::rgb565; // default
+// Choisit le décalage d'échelle (0..3 pour 1/1..1/8) le plus fort qui garde
+// l'image au moins aussi grande que width/height_override, puis réduit
+// encore si nécessaire pour respecter les dimensions maximales
+int SdImageComponent::select_jpeg_scale(int width, int height, const LoadRequest &request) {
+  int shift = 0;
+  if (request.width_override > 0 || request.height_override > 0) {
+    while (shift < 3 && (width >> (shift + 1)) >= request.width_override &&
+           (height >> (shift + 1)) >= request.height_override) {
+      shift++;
+    }
   }
-}
-
-void SdImageComponent::set_byte_order_string(const std::string &byte_order) {
-  if (byte_order == "BIG_ENDIAN") this->byte_order_ = ByteOrder::big_endian;
-  else if (byte_order == "LITTLE_ENDIAN") this->byte_order_ = ByteOrder::little_endian;
-  else {
-    ESP_LOGW(TAG_IMAGE, "Unknown byte order: %s, using little_endian", byte_order.c_str());
-    this->byte_order_ = ByteOrder::little_endian; // default
+  while (shift < 3 && ((width >> shift) > MAX_IMAGE_WIDTH || (height >> shift) > MAX_IMAGE_HEIGHT)) {
+    shift++;
   }
+  return shift;
 }
 
-bool SdImageComponent::load_image() {
-  return this->load_image_from_path(this->file_path_);
+bool SdImageComponent::decode_png(const std::vector<uint8_t> &png_data, LoadedImage &image) const {
+  PngStreamDecoder decoder([&png_data](size_t offset, size_t length, uint8_t *dst) {
+    if (offset + length > png_data.size())
+      return false;
+    memcpy(dst, png_data.data() + offset, length);
+    return true;
+  });
+  return this->decode_png_stream(decoder, image);
 }
 
-bool SdImageComponent::load_image_from_path(const std::string &path) {
-  ESP_LOGD(TAG_IMAGE, "Loading image from: %s", path.c_str());
+bool SdImageComponent::decode_png_stream(PngStreamDecoder &decoder, LoadedImage &image) const {
+  if (!decoder.read_header()) {
+    return false;
+  }
   
-  if (!this->storage_component_) {
-    ESP_LOGE(TAG_IMAGE, "Storage component not available");
+  const int width = decoder.get_width();
+  const int height = decoder.get_height();
+  if (width > MAX_IMAGE_WIDTH || height > MAX_IMAGE_HEIGHT) {
+    ESP_LOGE(TAG_IMAGE, "PNG too large: %dx%d", width, height);
     return false;
   }
   
-  // Libérer l'image précédente si chargée
-  if (this->is_loaded_) {
-    this->unload_image();
+  const OutputImageFormat output_format = image.request.output_format;
+  const size_t row_size = width * PngStreamDecoder::get_output_pixel_size(output_format);
+  if (!image.data.allocate(row_size * height)) {
+    return false;
   }
+  uint8_t *pixels = image.data.data();
   
-  // Vérifier si le fichier existe
-  if (!this->storage_component_->file_exists_direct(path)) {
-    ESP_LOGE(TAG_IMAGE, "Image file not found: %s", path.c_str());
+  // Chaque ligne décodée est copiée directement à sa place dans le buffer final
+  bool ok = decoder.decode(output_format, [pixels, row_size](int y, const uint8_t *row) {
+    memcpy(pixels + y * row_size, row, row_size);
+  });
+  if (!ok) {
     return false;
   }
   
-  // Lire les données depuis la SD
-  std::vector<uint8_t> data = this->storage_component_->read_file_direct(path);
+  image.width = width;
+  image.height = height;
+  image.format = get_decoded_format(output_format);
   
-  if (data.empty()) {
-    ESP_LOGE(TAG_IMAGE, "Failed to read image file: %s", path.c_str());
+  ESP_LOGD(TAG_IMAGE, "PNG decoded: %dx%d", width, height);
+  return true;
+}
+
+// Format des pixels produits par les décodeurs JPEG/PNG
+ImageFormat SdImageComponent::get_decoded_format(OutputImageFormat format) {
+  switch (format) {
+    case OutputImageFormat::rgb888:
+      return ImageFormat::rgb888;
+    case OutputImageFormat::rgba:
+      return ImageFormat::rgba;
+    case OutputImageFormat::rgb565:
+    default:
+      return ImageFormat::rgb565;
+  }
+}
+
+std::function<bool(size_t, size_t, uint8_t *)> SdImageComponent::make_storage_reader(const std::string &path) const {
+  StorageComponent *storage = this->storage_component_;
+  return [storage, path](size_t offset, size_t length, uint8_t *dst) {
+    return storage->read_range(path, offset, length, dst);
+  };
+}
+
+// Lit les dimensions dans l'en-tête JPEG/PNG par lectures partielles:
+// seuls la signature, l'IHDR ou les en-têtes de segments JPEG sont lus,
+// jamais le fichier entier. Pour un JPEG, renvoie la taille après la
+// réduction qu'appliquera decode_jpeg().
+bool SdImageComponent::probe_image_dimensions(const std::string &path, const LoadRequest &request, int &width,
+                                              int &height) const {
+  if (!this->storage_component_) {
     return false;
   }
   
-  // Vérifier la taille des données
-  if (this->expected_data_size_ > 0 && data.size() != this->expected_data_size_) {
-    ESP_LOGW(TAG_IMAGE, "Image size mismatch. Expected: %zu, Got: %zu", 
-             this->expected_data_size_, data.size());
-    // Continuer quand même, mais avec avertissement
+  std::vector<uint8_t> header(24);
+  if (!this->storage_component_->read_range(path, 0, header.size(), header.data())) {
+    return false;
   }
   
-  // Conversion de l'ordre des bytes si nécessaire
-  if (this->byte_order_ == ByteOrder::big_endian && this->get_pixel_size() > 1) {
-    this->convert_byte_order(data);
+  if (this->is_png_file(header)) {
+    return this->extract_png_dimensions(header, width, height);
   }
-  
-  // Stocker les données
-  if (this->cache_enabled_) {
-    this->image_data_ = std::move(data);
-    this->is_loaded_ = true;
-    ESP_LOGD(TAG_IMAGE, "Image loaded and cached: %zu bytes", this->image_data_.size());
-  } else {
-    // Mode streaming - pas de cache
-    this->streaming_mode_ = true;
-    this->is_loaded_ = true;
-    ESP_LOGD(TAG_IMAGE, "Image loaded in streaming mode");
+  if (ImageAssetHeader::has_magic(header.data(), header.size())) {
+    ImageAssetHeader asset;
+    if (!this->read_asset_header(path, asset)) {
+      return false;
+    }
+    width = asset.width;
+    height = asset.height;
+    return true;
+  }
+  if (!this->is_jpeg_file(header)) {
+    return false;
   }
   
-  // Mettre à jour le chemin actuel
-  this->file_path_ = path;
-  
-  return true;
+  // Parcours des segments JPEG: 9 octets lus par segment au maximum
+  size_t offset = 2;
+  uint8_t segment[9];
+  for (int i = 0; i < 64; i++) {
+    if (!this->storage_component_->read_range(path, offset, sizeof(segment), segment) || segment[0] != 0xFF) {
+      return false;
+    }
+    uint8_t marker = segment[1];
+    if (marker == 0xFF) {
+      // Octet de remplissage
+      offset++;
+      continue;
+    }
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+      int source_height = (segment[5] << 8) | segment[6];
+      int source_width = (segment[7] << 8) | segment[8];
+      if (source_width <= 0 || source_height <= 0) {
+        return false;
+      }
+      int divisor = 1 << select_jpeg_scale(source_width, source_height, request);
+      width = (source_width + divisor - 1) / divisor;
+      height = (source_height + divisor - 1) / divisor;
+      ESP_LOGV(TAG_IMAGE, "Probed JPEG %dx%d (decoded as %dx%d) at offset %zu", source_width, source_height,
+               width, height, offset);
+      return true;
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      return false;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      offset += 2;
+      continue;
+    }
+    offset += 2 + ((segment[2] << 8) | segment[3]);
+  }
+  return false;
+}
+
+bool SdImageComponent::extract_png_dimensions(const std::vector<uint8_t> &data, int &width, int &height) const {
+  // Signature (8) + longueur (4) + "IHDR" (4) + largeur (4) + hauteur (4)
+  if (!this->is_png_file(data) || data.size() < 24 || memcmp(&data[12], "IHDR", 4) != 0) {
+    return false;
+  }
+  width = (data[16] << 24) | (data[17] << 16) | (data[18] << 8) | data[19];
+  height = (data[20] << 24) | (data[21] << 16) | (data[22] << 8) | data[23];
+  return width > 0 && height > 0;
 }
 
 void SdImageComponent::unload_image() {
   ESP_LOGD(TAG_IMAGE, "Unloading image");
   
   if (this->cache_enabled_) {
-    this->image_data_.clear();
-    this->image_data_.shrink_to_fit();
+    this->image_data_.release();
   }
   
+  this->stream_buffer_.clear();
+  this->stream_buffer_.shrink_to_fit();
+  this->row_colors_.clear();
+  this->row_colors_.shrink_to_fit();
+  this->row_alpha_.clear();
+  this->row_alpha_.shrink_to_fit();
+  this->row_565_.clear();
+  this->row_565_.shrink_to_fit();
+  this->reset_pixel_row();
+  
   this->is_loaded_ = false;
   this->streaming_mode_ = false;
+  this->stream_png_ = false;
+  this->evicted_ = false;
+  ImageMemoryManager::get_instance()->on_unloaded(this);
   
   ESP_LOGD(TAG_IMAGE, "Image unloaded");
 }
 
+// Appelé par ImageMemoryManager: libère les pixels, l'image sera relue au
+// prochain draw()
+void SdImageComponent::evict() {
+  this->unload_image();
+  this->evicted_ = true;
+}
+
+void SdImageComponent::set_memory_budget(size_t budget) {
+  ImageMemoryManager::get_instance()->set_budget(budget);
+}
+
 bool SdImageComponent::reload_image() {
   ESP_LOGD(TAG_IMAGE, "Reloading image");
   return this->load_image_from_path(this->file_path_);
@@ -241,28 +1501,392 @@ bool SdImageComponent::reload_image() {
 
 // Méthodes héritées de image::Image
 void SdImageComponent::draw(int x, int y, display::Display *display, Color color_on, Color color_off) {
+  // Un rechargement après éviction compte dans les octets lus par ce draw
+  size_t bytes_before = this->storage_component_ ? this->storage_component_->get_bytes_read() : 0;
+  if (this->evicted_) {
+    // Évincée pour respecter le budget mémoire: rechargement transparent
+    ESP_LOGD(TAG_IMAGE, "Reloading evicted image: %s", this->file_path_.c_str());
+    this->evicted_ = false;
+    ImageMemoryManager::get_instance()->on_reloaded();
+    this->load_image_from_path(this->file_path_);
+  }
+  
+  if (this->is_loaded_ && this->streaming_mode_) {
+    uint32_t start = micros();
+    this->draw_streamed(x, y, display, color_on, color_off);
+    this->finish_draw("Streamed", start, bytes_before);
+    return;
+  }
+  
   if (!this->is_loaded_ || this->image_data_.empty()) {
     ESP_LOGW(TAG_IMAGE, "Cannot draw: image not loaded");
     return;
   }
+  
+  ImageMemoryManager::get_instance()->on_drawn(this);
+  uint32_t start = micros();
+  
+  // Chemin rapide: le format source est directement compris par le display,
+  // toute l'image part en un seul appel au lieu d'un appel par pixel
+  display::ColorBitness bitness;
+  if (this->get_native_bitness(display, bitness)) {
+    size_t row_size = this->get_row_stride();
+    int rows = std::min<int>(this->height_, this->image_data_.size() / row_size);
+    // Octets de fin de ligne sautés par le display, comptés en pixels
+    int x_pad = (row_size - this->width_ * this->get_pixel_size()) / this->get_pixel_size();
+    if (rows > 0) {
+      display->draw_pixels_at(x, y, this->width_, rows, this->image_data_.data(),
+                              display::COLOR_ORDER_RGB, bitness, false, 0, 0, x_pad);
+    }
+    this->finish_draw("Bulk", start, bytes_before);
+    return;
+  }
+  
+  const size_t row_size = this->get_row_stride();
+  const int rows = std::min<int>(this->height_, this->image_data_.size() / row_size);
+  this->prepare_row_buffers();
+  
+  if (this->format_ == ImageFormat::binary) {
+    const uint16_t colors[2] = {to_rgb565(color_off), to_rgb565(color_on)};
+    for (int img_y = 0; img_y < rows; img_y++) {
+      this->draw_binary_row(this->image_data_.data() + img_y * row_size, x, y + img_y, display, colors, color_on);
+    }
+    this->finish_draw("Binary", start, bytes_before);
+    return;
+  }
+  
+  if (this->format_ == ImageFormat::indexed) {
+    for (int img_y = 0; img_y < rows; img_y++) {
+      this->draw_indexed_row(this->image_data_.data() + img_y * row_size, x, y + img_y, display);
+    }
+    this->finish_draw("Palette", start, bytes_before);
+    return;
+  }
+
+  bool has_alpha;
+  RowKernel kernel = select_row_kernel(this->format_, this->chroma_key_, has_alpha);
+  for (int img_y = 0; img_y < rows; img_y++) {
+#ifdef STORAGE_KERNEL_STATS
+    uint32_t cycles = arch_get_cpu_cycle_count();
+#endif
+    kernel(this->image_data_.data() + img_y * row_size, this->width_, this->row_colors_.data(),
+           this->row_alpha_.data());
+#ifdef STORAGE_KERNEL_STATS
+    this->kernel_cycles_ += arch_get_cpu_cycle_count() - cycles;
+    this->kernel_pixels_ += this->width_;
+#endif
+    this->blit_row(x, y + img_y, display, has_alpha);
+  }
+  
+  this->finish_draw("Row kernel", start, bytes_before);
+}
+
+void SdImageComponent::finish_draw(const char *kind, uint32_t start, size_t bytes_before) {
+  this->last_draw_time_us_ = micros() - start;
+  this->last_draw_bytes_read_ =
+      this->storage_component_ ? this->storage_component_->get_bytes_read() - bytes_before : 0;
+  this->draw_count_++;
+  this->draw_time_us_ += this->last_draw_time_us_;
+  this->draw_bytes_read_ += this->last_draw_bytes_read_;
+  ESP_LOGV(TAG_IMAGE, "%s draw took %u us, %zu bytes read", kind, (unsigned) this->last_draw_time_us_,
+           this->last_draw_bytes_read_);
+}
+
+// Bilan des draws depuis le précédent: durée et octets lus sur la carte par
+// draw, puis en log verbose le coût par pixel des noyaux de conversion s'ils
+// ont servi; rien si l'image n'a pas été dessinée
+void SdImageComponent::log_draw_stats() {
+  if (this->draw_count_ == 0) {
+    return;
+  }
+  ESP_LOGD(TAG_IMAGE, "%s: %u draws, %u us and %zu bytes read per draw", this->file_path_.c_str(),
+           (unsigned) this->draw_count_, (unsigned) (this->draw_time_us_ / this->draw_count_),
+           this->draw_bytes_read_ / this->draw_count_);
+#ifdef STORAGE_KERNEL_STATS
+  if (this->kernel_pixels_ > 0) {
+    float cycles_per_pixel = static_cast<float>(this->kernel_cycles_) / this->kernel_pixels_;
+    ESP_LOGV(TAG_IMAGE, "%s: conversion kernel %.1f cycles (%.1f ns) per pixel over %llu pixels",
+             this->file_path_.c_str(), cycles_per_pixel, cycles_per_pixel * 1e9f / arch_get_cpu_freq_hz(),
+             (unsigned long long) this->kernel_pixels_);
+  }
+  this->kernel_cycles_ = 0;
+  this->kernel_pixels_ = 0;
+#endif
+  this->draw_count_ = 0;
+  this->draw_time_us_ = 0;
+  this->draw_bytes_read_ = 0;
+}
+
+void SdImageComponent::prepare_row_buffers() {
+  if (this->row_colors_.size() < static_cast<size_t>(this->width_)) {
+    this->row_colors_.resize(this->width_);
+    this->row_alpha_.resize(this->width_);
+  }
+  bool bulk = this->format_ == ImageFormat::binary ||
+              (this->format_ == ImageFormat::indexed && !this->palette_has_alpha_);
+  if (bulk && this->row_565_.size() < static_cast<size_t>(this->width_)) {
+    this->row_565_.resize(this->width_);
+  }
+}
+
+// Une entrée par indice possible: un indice hors palette donne du noir au
+// lieu d'une lecture hors table
+void SdImageComponent::build_palette(const std::vector<uint8_t> &palette) {
+  size_t entries = this->format_ == ImageFormat::indexed ? (size_t(1) << this->index_bits_) : 0;
+  this->palette_colors_.assign(entries, Color(0, 0, 0));
+  this->palette_alpha_.assign(entries, 255);
+  this->palette_565_.assign(entries, 0);
+  this->palette_has_alpha_ = false;
+  for (size_t i = 0; i < entries && 4 * i + 4 <= palette.size(); i++) {
+    const uint8_t *entry = palette.data() + 4 * i;
+    this->palette_colors_[i] = Color(entry[0], entry[1], entry[2]);
+    this->palette_alpha_[i] = entry[3];
+    this->palette_565_[i] = to_rgb565(this->palette_colors_[i]);
+    if (entry[3] != 255) {
+      this->palette_has_alpha_ = true;
+    }
+  }
+}
+
+// Binaire: chaque bit devient color_on ou color_off (en RGB565), la ligne part
+// en un seul appel. Avec une couleur clé, les pixels éteints sont transparents.
+void SdImageComponent::draw_binary_row(const uint8_t *src, int x, int y, display::Display *display,
+                                       const uint16_t *colors, Color color_on) {
+  if (this->chroma_key_) {
+    static const uint8_t BINARY_ALPHA[2] = {0, 255};
+    std::fill_n(this->row_colors_.data(), this->width_, color_on);
+    expand_bits(src, this->width_, BINARY_ALPHA, this->row_alpha_.data());
+    this->blit_row(x, y, display, true);
+    return;
+  }
+  expand_bits(src, this->width_, colors, this->row_565_.data());
+  display->draw_pixels_at(x, y, this->width_, 1, reinterpret_cast<const uint8_t *>(this->row_565_.data()),
+                          display::COLOR_ORDER_RGB, display::COLOR_BITNESS_565, false);
+}
 
-  for (int img_y = 0; img_y < this->height_; img_y++) {
-    for (int img_x = 0; img_x < this->width_; img_x++) {
-      uint8_t red, green, blue, alpha;
-      this->get_pixel(img_x, img_y, red, green, blue, alpha);
+// Palette opaque: la ligne est développée en RGB565 et envoyée en un seul
+// appel; sinon elle passe par blit_row() pour sauter les pixels transparents
+void SdImageComponent::draw_indexed_row(const uint8_t *src, int x, int y, display::Display *display) {
+  if (!this->palette_has_alpha_) {
+    expand_indices(src, this->index_bits_, this->width_, this->palette_565_.data(), this->row_565_.data());
+    // uint16_t en mémoire little-endian, comme les images RGB565 chargées
+    display->draw_pixels_at(x, y, this->width_, 1, reinterpret_cast<const uint8_t *>(this->row_565_.data()),
+                            display::COLOR_ORDER_RGB, display::COLOR_BITNESS_565, false);
+    return;
+  }
+  expand_indices(src, this->index_bits_, this->width_, this->palette_colors_.data(), this->row_colors_.data());
+  expand_indices(src, this->index_bits_, this->width_, this->palette_alpha_.data(), this->row_alpha_.data());
+  this->blit_row(x, y, display, true);
+}
 
+void SdImageComponent::blit_row(int x, int y, display::Display *display, bool has_alpha) {
+  const Color *colors = this->row_colors_.data();
+  if (has_alpha) {
+    const uint8_t *alpha = this->row_alpha_.data();
+    for (int i = 0; i < this->width_; i++) {
       // Si alpha == 0, pixel transparent, on saute
-      if (alpha == 0)
+      if (alpha[i] != 0)
+        display->draw_absolute_pixel(x + i, y, colors[i]);
+    }
+  } else {
+    for (int i = 0; i < this->width_; i++)
+      display->draw_absolute_pixel(x + i, y, colors[i]);
+  }
+}
+
+// Formats transmissibles tels quels à display::Display::draw_pixels_at(), si le
+// display est en couleur: un display binaire ou en niveaux de gris
+// reconvertirait chaque pixel. Les données en RAM sont toujours little-endian
+// après load_image_from_path().
+bool SdImageComponent::get_native_bitness(display::Display *display, display::ColorBitness &bitness) const {
+  if (display->get_display_type() != display::DISPLAY_TYPE_COLOR) {
+    return false;
+  }
+  // La couleur clé doit être sautée pixel par pixel
+  if (this->chroma_key_) {
+    return false;
+  }
+  switch (this->format_) {
+    case ImageFormat::rgb565:
+      bitness = display::COLOR_BITNESS_565;
+      return true;
+    case ImageFormat::rgb888:
+      bitness = display::COLOR_BITNESS_888;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Mode streaming: lit l'image par bandes de `stream_band_height_` lignes dans un
+// buffer de travail fixe, au lieu de charger tout le fichier en RAM
+void SdImageComponent::draw_streamed(int x, int y, display::Display *display, Color color_on, Color color_off) {
+  if (!this->storage_component_ || this->width_ <= 0 || this->height_ <= 0) {
+    return;
+  }
+  
+  if (this->stream_png_) {
+    this->draw_streamed_png(x, y, display);
+    return;
+  }
+  
+  const int band_height = std::max(1, std::min(this->stream_band_height_, this->height_));
+  const bool is_binary = this->format_ == ImageFormat::binary;
+  const bool is_indexed = this->format_ == ImageFormat::indexed;
+  const uint16_t binary_colors[2] = {to_rgb565(color_off), to_rgb565(color_on)};
+  const size_t pixel_size = this->get_pixel_size();
+  const size_t row_size = this->get_row_stride();
+  
+  if (this->stream_buffer_.size() < this->get_stream_buffer_size()) {
+    this->stream_buffer_.resize(this->get_stream_buffer_size());
+  }
+  uint8_t *band = this->stream_buffer_.data();
+  display::ColorBitness bitness;
+  const bool native = this->get_native_bitness(display, bitness);
+  const int x_pad = native ? (row_size - this->width_ * pixel_size) / pixel_size : 0;
+  // Le display lit lui-même le RGB565 big-endian; seuls les noyaux de
+  // conversion attendent des pixels little-endian
+  const bool big_endian = this->stream_byte_order_ == ByteOrder::big_endian && pixel_size > 1;
+  bool has_alpha = false;
+  RowKernel kernel = nullptr;
+  if (!native) {
+    if (!is_binary && !is_indexed) {
+      kernel = select_row_kernel(this->format_, this->chroma_key_, has_alpha);
+    }
+    this->prepare_row_buffers();
+  }
+  size_t bytes_before = this->storage_component_->get_bytes_read();
+  
+  // Seules les lignes visibles sont lues ou décodées: le coût d'un draw
+  // partiel suit la zone affichée, pas la taille du fichier
+  int first_row, last_row;
+  this->get_visible_rows(y, display, first_row, last_row);
+  if (first_row >= last_row) {
+    return;
+  }
+  
+  // Compressé: les lignes sont décodées dans la bande au lieu d'y être lues
+  std::unique_ptr<RleRowDecoder> decoder = this->make_rle_decoder();
+  if (decoder && !this->seek_rle_row(*decoder, first_row)) {
+    ESP_LOGW(TAG_IMAGE, "Streaming seek failed at row %d", first_row);
+    return;
+  }
+  
+  for (int band_y = first_row; band_y < last_row; band_y += band_height) {
+    const int rows = std::min(band_height, last_row - band_y);
+    
+    const size_t length = rows * row_size;
+    if (decoder) {
+      for (int row = 0; row < rows; row++) {
+        if (!decoder->decode_row(band + row * row_size)) {
+          ESP_LOGW(TAG_IMAGE, "Streaming decode failed at row %d", band_y + row);
+          return;
+        }
+      }
+    } else if (!this->storage_component_->read_range(this->file_path_, this->payload_offset_ + band_y * row_size,
+                                                     length, band)) {
+      ESP_LOGW(TAG_IMAGE, "Streaming read failed at row %d", band_y);
+      return;
+    }
+    
+    if (big_endian && !native) {
+      this->convert_byte_order(band, length);
+    }
+    
+    if (native) {
+      display->draw_pixels_at(x, y + band_y, this->width_, rows, band, display::COLOR_ORDER_RGB, bitness, big_endian,
+                              0, 0, x_pad);
+      continue;
+    }
+    
+    for (int row = 0; row < rows; row++) {
+      const uint8_t *src = band + row * row_size;
+      if (is_binary) {
+        this->draw_binary_row(src, x, y + band_y + row, display, binary_colors, color_on);
+        continue;
+      }
+      if (is_indexed) {
+        this->draw_indexed_row(src, x, y + band_y + row, display);
         continue;
+      }
+#ifdef STORAGE_KERNEL_STATS
+      uint32_t cycles = arch_get_cpu_cycle_count();
+#endif
+      kernel(src, this->width_, this->row_colors_.data(), this->row_alpha_.data());
+#ifdef STORAGE_KERNEL_STATS
+      this->kernel_cycles_ += arch_get_cpu_cycle_count() - cycles;
+      this->kernel_pixels_ += this->width_;
+#endif
+      this->blit_row(x, y + band_y + row, display, has_alpha);
+    }
+  }
+  
+  ESP_LOGV(TAG_IMAGE, "Streamed draw of rows %d-%d read %zu bytes", first_row, last_row - 1,
+           this->storage_component_->get_bytes_read() - bytes_before);
+}
+
+void SdImageComponent::get_visible_rows(int y, display::Display *display, int &first, int &last) const {
+  first = std::max(0, -y);
+  last = std::min(this->height_, display->get_height() - y);
+  if (display->is_clipping()) {
+    display::Rect clip = display->get_clipping();
+    first = std::max(first, clip.y - y);
+    last = std::min(last, clip.y2() - y);
+  }
+}
 
-      Color pixel_color(red, green, blue);
-      display->draw_absolute_pixel(x + img_x, y + img_y, pixel_color);
+// PNG en streaming: chaque ligne décodée part directement vers le display
+void SdImageComponent::draw_streamed_png(int x, int y, display::Display *display) {
+  PngStreamDecoder decoder(this->make_storage_reader(this->file_path_));
+  
+  display::ColorBitness bitness;
+  const bool native = this->get_native_bitness(display, bitness);
+  bool has_alpha = false;
+  RowKernel kernel = nullptr;
+  if (!native) {
+    kernel = select_row_kernel(this->format_, this->chroma_key_, has_alpha);
+    this->prepare_row_buffers();
+  }
+  
+  bool ok = decoder.decode(this->output_format_, [&](int row_y, const uint8_t *row) {
+    if (row_y >= this->height_)
+      return;
+    if (native) {
+      display->draw_pixels_at(x, y + row_y, this->width_, 1, row, display::COLOR_ORDER_RGB, bitness, false);
+    } else {
+#ifdef STORAGE_KERNEL_STATS
+      uint32_t cycles = arch_get_cpu_cycle_count();
+#endif
+      kernel(row, this->width_, this->row_colors_.data(), this->row_alpha_.data());
+#ifdef STORAGE_KERNEL_STATS
+      this->kernel_cycles_ += arch_get_cpu_cycle_count() - cycles;
+      this->kernel_pixels_ += this->width_;
+#endif
+      this->blit_row(x, y + row_y, display, has_alpha);
     }
+  });
+  if (!ok) {
+    ESP_LOGW(TAG_IMAGE, "Streaming PNG decode failed: %s", this->file_path_.c_str());
+  }
+}
+
+size_t SdImageComponent::get_stream_buffer_size() const {
+  if (this->width_ <= 0 || this->height_ <= 0) {
+    return 0;
+  }
+  if (this->stream_png_) {
+    // Fenêtre zlib + état de l'inflateur + deux lignes + ligne de sortie
+    return PngStreamDecoder::estimate_memory_usage(this->width_);
   }
+  const int band_height = std::max(1, std::min(this->stream_band_height_, this->height_));
+  // Compressé: tampon de lecture du décodeur en plus
+  size_t input = this->compression_ == PayloadCompression::none ? 0 : sizeof(RleRowDecoder);
+  return static_cast<size_t>(band_height) * this->get_row_stride() + input;
 }
 
+#ifdef USE_IMAGE
 // FIXED: Renamed from get_type() to get_image_type() to match header declaration
-ImageType SdImageComponent::get_image_type() const {
+image::ImageType SdImageComponent::get_image_type() const {
   switch (this->format_) {
     case ImageFormat::rgb565:
       return image::IMAGE_TYPE_RGB565;
@@ -278,6 +1902,7 @@ ImageType SdImageComponent::get_image_type() const {
       return image::IMAGE_TYPE_RGB565;
   }
 }
+#endif
 
 // Version sans alpha
 void SdImageComponent::get_pixel(int x, int y, uint8_t &red, uint8_t &green, uint8_t &blue) const {
@@ -310,7 +1935,7 @@ void SdImageComponent::get_pixel(int x, int y, uint8_t &red, uint8_t &green, uin
     return;
   }
   
-  const uint8_t *pixel_data = &this->image_data_[offset];
+  const uint8_t *pixel_data = this->image_data_.data() + offset;
   this->convert_pixel_format(x, y, pixel_data, red, green, blue, alpha);
 }
 
@@ -332,14 +1957,45 @@ void SdImageComponent::get_pixel_streamed(int x, int y, uint8_t &red, uint8_t &g
   size_t pixel_size = this->get_pixel_size();
   
   // Lire seulement les bytes nécessaires pour ce pixel
-  std::vector<uint8_t> data = this->storage_component_->read_file_direct(this->file_path_);
-  
-  if (data.size() <= offset + pixel_size) {
+  uint8_t pixel_data[4];
+  if (this->compression_ == PayloadCompression::rle) {
+    // Compressé: la ligne du pixel est décodée une fois et gardée, les
+    // pixels voisins la relisent et la ligne suivante continue le décodage
+    size_t row_size = this->get_row_stride();
+    if (this->pixel_row_y_ != y) {
+      if (!this->pixel_decoder_ || this->pixel_row_y_ + 1 != y) {
+        this->pixel_decoder_ = this->make_rle_decoder();
+        if (!this->seek_rle_row(*this->pixel_decoder_, y)) {
+          this->reset_pixel_row();
+          red = green = blue = alpha = 0;
+          return;
+        }
+      }
+      this->pixel_row_.resize(row_size);
+      if (!this->pixel_decoder_->decode_row(this->pixel_row_.data())) {
+        this->reset_pixel_row();
+        red = green = blue = alpha = 0;
+        return;
+      }
+      this->pixel_row_y_ = y;
+    }
+    memcpy(pixel_data, this->pixel_row_.data() + (offset - y * row_size), pixel_size);
+  } else if (!this->storage_component_->read_range(this->file_path_, this->payload_offset_ + offset, pixel_size,
+                                                   pixel_data)) {
     red = green = blue = alpha = 0;
     return;
   }
   
-  const uint8_t *pixel_data = &data[offset];
+  // Même conversion que load_image_from_path() applique au fichier complet
+  if (this->stream_byte_order_ == ByteOrder::big_endian) {
+    if (pixel_size == 2) {
+      std::swap(pixel_data[0], pixel_data[1]);
+    } else if (pixel_size == 4) {
+      std::swap(pixel_data[0], pixel_data[3]);
+      std::swap(pixel_data[1], pixel_data[2]);
+    }
+  }
+  
   this->convert_pixel_format(x, y, pixel_data, red, green, blue, alpha);
 }
 
@@ -351,14 +2007,14 @@ void SdImageComponent::convert_pixel_format(int x, int y, const uint8_t *pixel_d
       red = ((pixel >> 11) & 0x1F) << 3;
       green = ((pixel >> 5) & 0x3F) << 2;
       blue = (pixel & 0x1F) << 3;
-      alpha = 255;
+      alpha = this->chroma_key_ && is_chroma_key<ImageFormat::rgb565>(pixel_data) ? 0 : 255;
       break;
     }
     case ImageFormat::rgb888:
       red = pixel_data[0];
       green = pixel_data[1];
       blue = pixel_data[2];
-      alpha = 255;
+      alpha = this->chroma_key_ && is_chroma_key<ImageFormat::rgb888>(pixel_data) ? 0 : 255;
       break;
     case ImageFormat::rgba:
       red = pixel_data[0];
@@ -368,21 +2024,36 @@ void SdImageComponent::convert_pixel_format(int x, int y, const uint8_t *pixel_d
       break;
     case ImageFormat::grayscale:  // Fixed spelling
       red = green = blue = pixel_data[0];
-      alpha = 255;
+      alpha = this->chroma_key_ && is_chroma_key<ImageFormat::grayscale>(pixel_data) ? 0 : 255;
       break;
     case ImageFormat::binary: {
-      int byte_index = (y * this->width_ + x) / 8;
-      int bit_index = (y * this->width_ + x) % 8;
-      bool pixel_on = (pixel_data[byte_index] >> (7 - bit_index)) & 1;
+      // pixel_data pointe sur l'octet contenant le pixel (get_pixel_offset())
+      bool pixel_on = (pixel_data[0] >> (7 - x % 8)) & 1;
       red = green = blue = pixel_on ? 255 : 0;
-      alpha = 255;
+      alpha = this->chroma_key_ && !pixel_on ? 0 : 255;
+      break;
+    }
+    case ImageFormat::indexed: {
+      // pixel_data pointe sur l'octet contenant l'indice du pixel
+      int per_byte = 8 / this->index_bits_;
+      int shift = 8 - this->index_bits_ * (x % per_byte + 1);
+      uint8_t index = (pixel_data[0] >> shift) & ((1 << this->index_bits_) - 1);
+      const Color &color = this->palette_colors_[index];
+      red = color.r;
+      green = color.g;
+      blue = color.b;
+      alpha = this->palette_alpha_[index];
       break;
     }
   }
 }
 
 size_t SdImageComponent::get_pixel_size() const {
-  switch (this->format_) {
+  return get_format_pixel_size(this->format_);
+}
+
+size_t SdImageComponent::get_format_pixel_size(ImageFormat format) {
+  switch (format) {
     case ImageFormat::rgb565:
       return 2;
     case ImageFormat::rgb888:
@@ -392,7 +2063,8 @@ size_t SdImageComponent::get_pixel_size() const {
     case ImageFormat::grayscale:  // Fixed spelling
       return 1;
     case ImageFormat::binary:
-      return 1; // Géré spécialement
+    case ImageFormat::indexed:
+      return 1;  // Octet contenant le pixel, voir get_row_stride()
     default:
       return 2;
   }
@@ -400,17 +2072,81 @@ size_t SdImageComponent::get_pixel_size() const {
 
 size_t SdImageComponent::get_pixel_offset(int x, int y) const {
   if (this->format_ == ImageFormat::binary) {
-    return (y * this->width_ + x) / 8;
+    return y * this->get_row_stride() + x / 8;
+  }
+  if (this->format_ == ImageFormat::indexed) {
+    return y * this->get_row_stride() + x / (8 / this->index_bits_);
+  }
+  return y * this->get_row_stride() + x * this->get_pixel_size();
+}
+
+// Octets par ligne: le pas de l'en-tête s'il y en a un. Les lignes binaires
+// sont complétées à l'octet, comme les écrit ImageBinary dans __init__.py
+size_t SdImageComponent::get_row_stride() const {
+  if (this->row_stride_ > 0) {
+    return this->row_stride_;
+  }
+  if (this->format_ == ImageFormat::binary) {
+    return (this->width_ + 7) / 8;
+  }
+  return this->width_ * this->get_pixel_size();
+}
+
+size_t SdImageComponent::get_rle_unit() const {
+  return this->get_pixel_size();
+}
+
+// Décodeur placé au début des pixels compressés de l'image courante, nul si
+// elle n'est pas compressée
+std::unique_ptr<RleRowDecoder> SdImageComponent::make_rle_decoder() const {
+  if (this->compression_ != PayloadCompression::rle) {
+    return nullptr;
+  }
+  return std::unique_ptr<RleRowDecoder>(new RleRowDecoder(this->make_storage_reader(this->file_path_),
+                                                          this->payload_offset_, this->payload_size_,
+                                                          this->get_rle_unit(), this->get_row_stride()));
+}
+
+void SdImageComponent::reset_pixel_row() const {
+  this->pixel_decoder_.reset();
+  this->pixel_row_.clear();
+  this->pixel_row_.shrink_to_fit();
+  this->pixel_row_y_ = -1;
+}
+
+bool SdImageComponent::seek_rle_row(RleRowDecoder &decoder, int row) const {
+  if (row <= 0) {
+    return true;
+  }
+  if (this->row_index_offset_ > 0) {
+    uint8_t entry[4];
+    if (!this->storage_component_->read_range(this->file_path_, this->row_index_offset_ + 4 * row, sizeof(entry),
+                                              entry)) {
+      return false;
+    }
+    decoder.seek(entry[0] | (entry[1] << 8) | (entry[2] << 16) | (static_cast<uint32_t>(entry[3]) << 24));
+    return true;
   }
-  return (y * this->width_ + x) * this->get_pixel_size();
+  for (int i = 0; i < row; i++) {
+    if (!decoder.skip_row()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void SdImageComponent::convert_byte_order(std::vector<uint8_t> &data) {
-  size_t pixel_size = this->get_pixel_size();
-  
+  this->convert_byte_order(data.data(), data.size());
+}
+
+void SdImageComponent::convert_byte_order(uint8_t *data, size_t size) {
+  swap_byte_order(data, size, this->get_pixel_size());
+}
+
+void SdImageComponent::swap_byte_order(uint8_t *data, size_t size, size_t pixel_size) {
   if (pixel_size <= 1) return;
   
-  for (size_t i = 0; i < data.size(); i += pixel_size) {
+  for (size_t i = 0; i + pixel_size <= size; i += pixel_size) {
     if (pixel_size == 2) {
       std::swap(data[i], data[i + 1]);
     } else if (pixel_size == 4) {
@@ -421,7 +2157,8 @@ void SdImageComponent::convert_byte_order(std::vector<uint8_t> &data) {
 }
 
 bool SdImageComponent::validate_dimensions() const {
-  return this->width_ > 0 && this->height_ > 0 && this->width_ <= 1024 && this->height_ <= 768;
+  return this->width_ > 0 && this->height_ > 0 && this->width_ <= MAX_IMAGE_WIDTH &&
+         this->height_ <= MAX_IMAGE_HEIGHT;
 }
 
 bool SdImageComponent::validate_file_path() const {
@@ -429,10 +2166,7 @@ bool SdImageComponent::validate_file_path() const {
 }
 
 size_t SdImageComponent::calculate_expected_size() const {
-  if (this->format_ == ImageFormat::binary) {
-    return (this->width_ * this->height_ + 7) / 8;
-  }
-  return this->width_ * this->height_ * this->get_pixel_size();
+  return this->height_ * this->get_row_stride();
 }
 
 std::string SdImageComponent::get_format_string() const {
@@ -442,6 +2176,7 @@ std::string SdImageComponent::get_format_string() const {
     case ImageFormat::rgba: return "RGBA";
     case ImageFormat::grayscale: return "Grayscale";  // Fixed spelling
     case ImageFormat::binary: return "Binary";
+    case ImageFormat::indexed: return "Indexed";
     default: return "Unknown";
   }
 }
@@ -454,15 +2189,14 @@ bool SdImageComponent::validate_image_data() const {
     return this->image_data_.size() == expected_size;
   }
   
-  // Pour le mode streaming, vérifier que le fichier existe et a la bonne taille
-  std::vector<uint8_t> data = this->storage_component_->read_file_direct(this->file_path_);
-  return data.size() == expected_size;
+  // Pour le mode streaming, vérifier la taille du fichier sans le lire
+  size_t payload_size = this->payload_size_ > 0 ? this->payload_size_ : expected_size;
+  return this->storage_component_->get_file_size(this->file_path_) == this->payload_offset_ + payload_size;
 }
 
 void SdImageComponent::free_cache() {
   if (this->cache_enabled_) {
-    this->image_data_.clear();
-    this->image_data_.shrink_to_fit();
+    this->image_data_.release();
   }
 }
 
@@ -471,13 +2205,13 @@ bool SdImageComponent::read_image_from_storage() {
     return false;
   }
   
-  std::vector<uint8_t> data = this->storage_component_->read_file_direct(this->file_path_);
-  if (data.empty()) {
+  size_t file_size = this->storage_component_->get_file_size(this->file_path_);
+  this->image_data_.set_placement(this->buffer_placement_);
+  if (file_size == 0 || !this->image_data_.allocate(file_size)) {
     return false;
   }
   
-  this->image_data_ = std::move(data);
-  return true;
+  return this->storage_component_->read_file_into(this->file_path_, this->image_data_.data(), file_size) == file_size;
 }
 
 }  // namespace storage
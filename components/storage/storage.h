@@ -5,21 +5,48 @@
 #include <functional>
 #include <cstring>
 #include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <atomic>
+#include <unordered_map>
 #include "esphome/core/component.h"
+#include "esphome/core/log.h"
 #include "esphome/core/automation.h"
+#include "esphome/core/helpers.h"
 #include "esphome/core/optional.h"
 #include "esphome/components/display/display.h"
+#include "block_cache.h"
+#include "image_buffer.h"
+#include "rle_stream.h"
 
 // Essayer d'inclure image si disponible
 #ifdef USE_IMAGE
 #include "esphome/components/image/image.h"
 #endif
 
+// Coût des noyaux de conversion compté en cycles CPU, seulement avec les
+// logs verbose: en production, la boucle de rendu n'est pas instrumentée
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+#define STORAGE_KERNEL_STATS
+#endif
+
 namespace esphome {
 namespace storage {
 
 // Forward declarations
 class StorageComponent;
+class PngStreamDecoder;
+struct ImageAssetHeader;
+
+// Format des pixels bruts stockés sur la SD
+enum class ImageFormat {
+  rgb565,
+  rgb888,
+  rgba,
+  grayscale,
+  binary,
+  indexed  // indices de 1/2/4/8 bits dans une palette (conteneur uniquement)
+};
 
 // Énumérations pour les formats d'image (JPEG/PNG uniquement)
 enum class OutputImageFormat {
@@ -33,6 +60,63 @@ enum class ByteOrder {
   big_endian
 };
 
+// Compression des pixels d'un conteneur (voir ImageAssetHeader)
+enum class PayloadCompression : uint8_t {
+  none,
+  rle  // lignes RLE indépendantes, voir RleRowDecoder
+};
+
+// Paramètres d'un chargement, copiés du composant à son lancement: la tâche
+// de fond ne lit ainsi aucun membre modifié par la boucle principale
+struct LoadRequest {
+  int width{0};
+  int height{0};
+  int width_override{0};
+  int height_override{0};
+  ImageFormat raw_format{ImageFormat::rgb565};
+  ByteOrder byte_order{ByteOrder::little_endian};
+  OutputImageFormat output_format{OutputImageFormat::rgb565};
+  bool cache_enabled{true};
+  BufferPlacement placement{BufferPlacement::automatic};
+  size_t expected_size{0};
+};
+
+// Image lue et décodée, prête à être installée par SdImageComponent::apply_image()
+struct LoadedImage {
+  LoadRequest request;
+  std::string path;
+  ImageBuffer data;
+  int width{0};
+  int height{0};
+  ImageFormat format{ImageFormat::rgb565};
+  // Disposition des pixels dans le fichier: 0 = lignes contiguës, sinon
+  // octets par ligne; les pixels commencent à `payload_offset`
+  size_t row_stride{0};
+  size_t payload_offset{0};
+  // Taille des pixels stockés (compressés ou non), 0 si inconnue
+  size_t payload_size{0};
+  // Offset de l'index des lignes compressées, 0 sans index
+  size_t row_index_offset{0};
+  PayloadCompression compression{PayloadCompression::none};
+  ByteOrder byte_order{ByteOrder::little_endian};
+  // Format indexé: bits par indice et palette (RGBA, 4 octets par entrée)
+  uint8_t index_bits{0};
+  std::vector<uint8_t> palette;
+  // Pixels de la couleur clé transparents (conteneur `chroma_key`)
+  bool chroma_key{false};
+  bool streaming{false};
+  bool stream_png{false};
+  size_t peak_bytes{0};
+  uint32_t load_time_ms{0};
+  // Octets effectivement lus sur la SD
+  size_t bytes_read{0};
+  // Lookups FAT évités grâce au cache de métadonnées de StorageComponent
+  uint32_t saved_sd_ops{0};
+  // Plus bas niveau de heap interne libre, avant et après le chargement
+  size_t heap_low_water_before{0};
+  size_t heap_low_water_after{0};
+};
+
 // Classe principale Storage (simplifiée)
 class StorageComponent : public Component {
  public:
@@ -47,22 +131,95 @@ class StorageComponent : public Component {
   void set_platform(const std::string &platform) { this->platform_ = platform; }
   void set_root_path(const std::string &root_path) { this->root_path_ = root_path; }
   void set_sd_component(Component *sd_component) { this->sd_component_ = sd_component; }
+  void set_cache_size(size_t cache_size) { this->cache_size_ = cache_size; }
   
   // Méthodes de fichier
   bool file_exists_direct(const std::string &path);
   std::vector<uint8_t> read_file_direct(const std::string &path);
+  // Lit tout le fichier dans `dst` sans allocation; renvoie sa taille, 0 en
+  // cas d'erreur ou si `capacity` est insuffisante
+  size_t read_file_into(const std::string &path, uint8_t *dst, size_t capacity);
   bool write_file_direct(const std::string &path, const std::vector<uint8_t> &data);
   size_t get_file_size(const std::string &path);
+  time_t get_file_mtime(const std::string &path);
+  // Oublie les tailles/dates et les blocs en cache (carte remplacée, fichiers
+  // modifiés ailleurs) et ferme le fichier ouvert pour les lectures partielles
+  void invalidate_metadata();
+  
+  // Lecture partielle: lit exactement `length` octets à partir de `offset` dans `dst`
+  bool read_range(const std::string &path, size_t offset, size_t length, uint8_t *dst);
   
   // Getters
   const std::string &get_platform() const { return this->platform_; }
   const std::string &get_root_path() const { return this->root_path_; }
   Component *get_sd_component() const { return this->sd_component_; }
+  size_t get_cache_size() const { return this->cache_size_; }
+  
+  // Statistiques de lecture (octets réellement lus sur la SD)
+  size_t get_bytes_read() const { return this->bytes_read_; }
+  uint32_t get_cache_hits() const { return this->block_cache_.get_hits(); }
+  uint32_t get_cache_misses() const { return this->block_cache_.get_misses(); }
+  // Lookups FAT évités par le cache de métadonnées
+  uint32_t get_metadata_hits() const { return this->metadata_hits_; }
+  void reset_read_stats() {
+    this->bytes_read_ = 0;
+    this->block_cache_.reset_stats();
+    this->logged_hits_ = 0;
+    this->logged_misses_ = 0;
+    this->logged_bytes_read_ = 0;
+  }
   
  private:
+  // Ce que l'on sait d'un fichier: identifiant pour le cache de blocs et métadonnées
+  struct FileEntry {
+    uint32_t id{0};
+    bool has_metadata{false};
+    size_t size{0};
+    time_t mtime{0};
+  };
+  
+  std::string build_full_path(const std::string &path) const;
+  void close_read_handle();
+  void log_read_stats();
+  // Seul accès aux données des fichiers, sous le cache comme pour les lectures
+  // directes; renvoie le nombre d'octets lus. io_mutex_ doit être pris.
+  // Passe par le VFS où le composant SD monte la carte (root_path_): son API
+  // ne lit que des fichiers entiers, sans offset.
+  size_t read_at(const std::string &path, size_t offset, size_t length, uint8_t *dst);
+  // Lecture servie par le cache de blocs; io_mutex_ doit être pris
+  bool read_range_cached(const std::string &path, size_t offset, size_t length, uint8_t *dst);
+  bool is_cacheable(size_t length) const;
+  FileEntry &get_file_entry(const std::string &path);
+  // io_mutex_ doit être pris
+  const FileEntry &get_metadata(const std::string &path);
+  
   std::string platform_;
-  std::string root_path_{"/");
+  std::string root_path_{"/"};
   Component *sd_component_{nullptr};
+  size_t cache_size_{0};
+  size_t bytes_read_{0};
+  
+  // Les chargements asynchrones lisent depuis une autre tâche
+  Mutex io_mutex_;
+  
+  // Dernier fichier ouvert en lecture, gardé ouvert entre deux read_range()
+  FILE *read_handle_{nullptr};
+  std::string read_handle_path_;
+  
+  // Cache de blocs dimensionné par cache_size_, sous toutes les lectures
+  BlockCache block_cache_;
+  std::unordered_map<std::string, FileEntry> files_;
+  uint32_t next_file_id_{0};
+  uint32_t metadata_hits_{0};
+  uint32_t metadata_misses_{0};
+  std::vector<uint8_t> block_scratch_;
+  
+  // Bilan périodique des lectures (voir log_read_stats())
+  static const uint32_t READ_STATS_INTERVAL_MS = 60000;
+  uint32_t last_stats_time_{0};
+  uint32_t logged_hits_{0};
+  uint32_t logged_misses_{0};
+  size_t logged_bytes_read_{0};
 };
 
 // CORRECTION: Hériter seulement de Component pour éviter les problèmes
@@ -71,25 +228,47 @@ class SdImageComponent : public Component {
   SdImageComponent() = default;
 
   void setup() override;
-  void loop() override {}
+  void loop() override;
   void dump_config() override;
   float get_setup_priority() const override { return setup_priority::DATA; }
   
   // Configuration de base
   void set_file_path(const std::string &path) { this->file_path_ = path; }
+  void set_format(ImageFormat format) { this->format_ = this->raw_format_ = format; }
+  void set_format_string(const std::string &format);
   void set_output_format(OutputImageFormat format) { this->output_format_ = format; }
   void set_output_format_string(const std::string &format);
   void set_byte_order_string(const std::string &byte_order);
   void set_storage_component(StorageComponent *storage) { this->storage_component_ = storage; }
   void set_width_override(int width) { this->width_override_ = width; }
   void set_height_override(int height) { this->height_override_ = height; }
+  void set_width(int width) { this->width_ = width; }
+  void set_height(int height) { this->height_ = height; }
+  void set_cache_enabled(bool enabled) { this->cache_enabled_ = enabled; }
+  void set_preload(bool preload) { this->preload_ = preload; }
+  void set_stream_band_height(int rows) { this->stream_band_height_ = rows; }
+  void set_async_load(bool async_load) { this->async_load_ = async_load; }
+  void set_double_buffer(bool double_buffer) { this->double_buffer_ = double_buffer; }
+  void set_buffer_placement(BufferPlacement placement) { this->buffer_placement_ = placement; }
+  // Budget partagé par toutes les images (voir ImageMemoryManager), 0 = illimité
+  void set_memory_budget(size_t budget);
   
   // Getters
   const std::string &get_file_path() const { return this->file_path_; }
   int get_width() const { return this->width_; }
   int get_height() const { return this->height_; }
   OutputImageFormat get_output_format() const { return this->output_format_; }
+  ImageFormat get_format() const { return this->format_; }
   bool is_loaded() const { return this->is_loaded_; }
+  bool is_streaming() const { return this->streaming_mode_; }
+  uint32_t get_last_draw_time_us() const { return this->last_draw_time_us_; }
+  size_t get_last_draw_bytes_read() const { return this->last_draw_bytes_read_; }
+  uint32_t get_last_load_time_ms() const { return this->last_load_time_ms_; }
+  size_t get_last_load_peak_bytes() const { return this->last_load_peak_bytes_; }
+  size_t get_last_load_bytes_read() const { return this->last_load_bytes_read_; }
+#ifdef USE_IMAGE
+  image::ImageType get_image_type() const;
+#endif
   
   // Méthodes de drawing compatibles avec ESPHome display
   void draw(int x, int y, display::Display *display, Color color_on, Color color_off);
@@ -102,8 +281,25 @@ class SdImageComponent : public Component {
   // Chargement/déchargement d'image (simplifié)
   bool load_image();
   bool load_image_from_path(const std::string &path);
+  bool load_image_from_path(const std::string &path, uint8_t *buffer, size_t capacity);
   void unload_image();
   bool reload_image();
+  // Libère les pixels pour le budget mémoire partagé; rechargés au prochain draw()
+  void evict();
+  bool is_evicted() const { return this->evicted_; }
+  
+  // Chargement non bloquant: lecture + décodage sur une tâche de fond,
+  // résultat installé au prochain loop()
+  bool load_image_async(const std::string &path);
+  bool is_async_load() const { return this->async_load_; }
+  bool is_load_pending() const { return this->load_state_.load() != LOAD_IDLE; }
+  
+  void add_on_load_complete_callback(std::function<void()> &&callback) {
+    this->load_complete_callback_.add(std::move(callback));
+  }
+  void add_on_load_error_callback(std::function<void()> &&callback) {
+    this->load_error_callback_.add(std::move(callback));
+  }
   
   // Accès aux pixels avec vérifications de sécurité
   void get_pixel(int x, int y, uint8_t &red, uint8_t &green, uint8_t &blue) const;
@@ -130,18 +326,8 @@ class SdImageComponent : public Component {
     return this->width_ > 0 && this->height_ > 0; 
   }
   
-  std::string get_debug_info() const {
-    char buffer[256];
-    snprintf(buffer, sizeof(buffer), 
-      "SdImage[%s]: %dx%d, %s, loaded=%s, size=%zu bytes",
-      this->file_path_.c_str(),
-      this->width_, this->height_,
-      this->get_output_format_string().c_str(),
-      this->is_loaded_ ? "yes" : "no",
-      this->image_data_.size()
-    );
-    return std::string(buffer);
-  }
+  // Inclut le partage du buffer et les octets économisés par la déduplication
+  std::string get_debug_info() const;
 
  private:
   // Configuration
@@ -151,30 +337,139 @@ class SdImageComponent : public Component {
   int width_override_{0};
   int height_override_{0};
   OutputImageFormat output_format_{OutputImageFormat::rgb565};
+  ImageFormat format_{ImageFormat::rgb565};
+  // Format configuré pour les fichiers bruts (format_ suit l'image décodée)
+  ImageFormat raw_format_{ImageFormat::rgb565};
   ByteOrder byte_order_{ByteOrder::little_endian};
+  bool cache_enabled_{true};
+  bool preload_{false};
+  size_t expected_data_size_{0};
   
   // État
   bool is_loaded_{false};
-  std::vector<uint8_t> image_data_;
+  bool evicted_{false};
+  bool streaming_mode_{false};
+  
+  // Image courante: octets par ligne (0 = contiguës), début des pixels dans
+  // le fichier et ordre de leurs octets sur la SD (pour le streaming)
+  size_t row_stride_{0};
+  size_t payload_offset_{0};
+  size_t payload_size_{0};
+  size_t row_index_offset_{0};
+  PayloadCompression compression_{PayloadCompression::none};
+  ByteOrder stream_byte_order_{ByteOrder::little_endian};
+  
+  // Format indexé: palette convertie une fois au chargement, en Color (+ alpha)
+  // et en RGB565 little-endian, le format natif du display
+  uint8_t index_bits_{8};
+  // Couleur clé transparente; pour le binaire, les pixels éteints
+  bool chroma_key_{false};
+  std::vector<Color> palette_colors_;
+  std::vector<uint8_t> palette_alpha_;
+  std::vector<uint16_t> palette_565_;
+  bool palette_has_alpha_{false};
+  
+  // Rendu streaming par bandes de lignes
+  int stream_band_height_{8};
+  bool stream_png_{false};
+  std::vector<uint8_t> stream_buffer_;
+  
+  // Ligne convertie par les noyaux de conversion avant affichage
+  std::vector<Color> row_colors_;
+  std::vector<uint8_t> row_alpha_;
+  // Ligne développée en RGB565 (binaire, palette opaque), envoyée d'un bloc
+  std::vector<uint16_t> row_565_;
+  
+  // get_pixel() en streaming compressé: dernière ligne décodée et décodeur
+  // placé sur la suivante, pour ne pas redécoder l'image à chaque pixel
+  mutable std::unique_ptr<RleRowDecoder> pixel_decoder_;
+  mutable std::vector<uint8_t> pixel_row_;
+  mutable int pixel_row_y_{-1};
+  
+  // Durée du dernier draw() et octets lus sur la carte pour lui (mesures de performance)
+  uint32_t last_draw_time_us_{0};
+  size_t last_draw_bytes_read_{0};
+  // Cumuls depuis le dernier bilan périodique des draws
+  static const uint32_t DRAW_STATS_INTERVAL_MS = 60000;
+  uint32_t last_draw_stats_time_{0};
+  uint32_t draw_count_{0};
+  uint64_t draw_time_us_{0};
+  size_t draw_bytes_read_{0};
+#ifdef STORAGE_KERNEL_STATS
+  // Coût des noyaux de conversion de lignes, en cycles CPU
+  uint64_t kernel_cycles_{0};
+  uint64_t kernel_pixels_{0};
+#endif
+  
+  // Chargement asynchrone
+  enum LoadState : uint8_t { LOAD_IDLE, LOAD_RUNNING, LOAD_DONE, LOAD_FAILED };
+  static void load_task(void *arg);
+  bool async_load_{false};
+  std::atomic<uint8_t> load_state_{LOAD_IDLE};
+  std::string pending_path_;
+  std::string queued_path_;
+  std::unique_ptr<LoadedImage> pending_image_;
+  CallbackManager<void()> load_complete_callback_;
+  CallbackManager<void()> load_error_callback_;
+  
+  // Double buffer: l'image courante reste affichable pendant un rechargement
+  bool double_buffer_{false};
+  size_t double_buffer_peak_bytes_{0};
+  uint32_t last_swap_time_us_{0};
+  
+  // Mesures du dernier chargement
+  uint32_t last_load_time_ms_{0};
+  size_t last_load_peak_bytes_{0};
+  size_t last_load_bytes_read_{0};
+  uint32_t last_load_saved_sd_ops_{0};
+  size_t heap_low_water_before_{0};
+  size_t heap_low_water_after_{0};
+  ImageBuffer image_data_;
+  BufferPlacement buffer_placement_{BufferPlacement::automatic};
   StorageComponent *storage_component_{nullptr};
   
   // Méthodes de décodage d'images (JPEG/PNG uniquement)
   bool is_jpeg_file(const std::vector<uint8_t> &data) const;
   bool is_png_file(const std::vector<uint8_t> &data) const;
-  bool decode_jpeg(const std::vector<uint8_t> &jpeg_data);
-  bool decode_png(const std::vector<uint8_t> &png_data);
-  bool load_raw_data(const std::vector<uint8_t> &raw_data);
+  bool read_image(const std::string &path, LoadedImage &image) const;
+  void apply_image(LoadedImage &&image);
+  bool decode_jpeg(const std::vector<uint8_t> &jpeg_data, LoadedImage &image) const;
+  bool decode_png(const std::vector<uint8_t> &png_data, LoadedImage &image) const;
+  bool decode_png_stream(PngStreamDecoder &decoder, LoadedImage &image) const;
+  static ImageFormat get_decoded_format(OutputImageFormat format);
+  std::function<bool(size_t, size_t, uint8_t *)> make_storage_reader(const std::string &path) const;
+  bool load_raw_data(const std::string &path, LoadedImage &image) const;
+  // Fichier avec en-tête (voir ImageAssetHeader): tout vient de l'en-tête
+  bool read_asset_header(const std::string &path, ImageAssetHeader &header) const;
+  bool apply_asset_header(const std::string &path, const ImageAssetHeader &header, LoadedImage &image) const;
+  bool load_asset_data(const std::string &path, const ImageAssetHeader &header, LoadedImage &image) const;
+  std::string get_share_key(const std::string &path, bool decoded, const LoadRequest &request) const;
+  LoadRequest make_load_request() const;
   
   // Méthodes privées pour l'extraction de métadonnées
   bool extract_jpeg_dimensions(const std::vector<uint8_t> &data, int &width, int &height) const;
   bool extract_png_dimensions(const std::vector<uint8_t> &data, int &width, int &height) const;
+  static int select_jpeg_scale(int width, int height, const LoadRequest &request);
+  bool probe_image_dimensions(const std::string &path, const LoadRequest &request, int &width, int &height) const;
   
   // Méthodes de conversion et validation
   void convert_pixel_format(int x, int y, const uint8_t *pixel_data, 
                            uint8_t &red, uint8_t &green, uint8_t &blue, uint8_t &alpha) const;
   size_t get_pixel_size() const;
+  static size_t get_format_pixel_size(ImageFormat format);
+  static void swap_byte_order(uint8_t *data, size_t size, size_t pixel_size);
   size_t get_pixel_offset(int x, int y) const;
+  size_t get_row_stride() const;
+  // Unité des runs RLE: un pixel, un octet pour le binaire et l'indexé
+  size_t get_rle_unit() const;
+  std::unique_ptr<RleRowDecoder> make_rle_decoder() const;
+  // Place le décodeur au début de la ligne `row`: via l'index s'il existe,
+  // sinon en passant les lignes précédentes
+  bool seek_rle_row(RleRowDecoder &decoder, int row) const;
+  // Oublie la ligne gardée par get_pixel_streamed()
+  void reset_pixel_row() const;
   void convert_byte_order(std::vector<uint8_t> &data);
+  void convert_byte_order(uint8_t *data, size_t size);
   
   bool validate_dimensions() const;
   bool validate_file_path() const;
@@ -189,6 +484,24 @@ class SdImageComponent : public Component {
   // Méthodes streaming et cache
   void get_pixel_streamed(int x, int y, uint8_t &red, uint8_t &green, uint8_t &blue) const;
   void get_pixel_streamed(int x, int y, uint8_t &red, uint8_t &green, uint8_t &blue, uint8_t &alpha) const;
+  void draw_streamed(int x, int y, display::Display *display, Color color_on, Color color_off);
+  // Lignes de l'image visibles une fois placée en `y` (écran et clipping)
+  void get_visible_rows(int y, display::Display *display, int &first, int &last) const;
+  void draw_streamed_png(int x, int y, display::Display *display);
+  bool get_native_bitness(display::Display *display, display::ColorBitness &bitness) const;
+  // Fin d'un draw(): durée et octets lus, cumulés pour le bilan périodique
+  void finish_draw(const char *kind, uint32_t start, size_t bytes_before);
+  void log_draw_stats();
+  void prepare_row_buffers();
+  void blit_row(int x, int y, display::Display *display, bool has_alpha);
+  // Binaire: une ligne de bits affichée avec colors[0] (éteint) et colors[1] (allumé), en RGB565;
+  // avec une couleur clé, seuls les pixels allumés sont dessinés, en color_on
+  void draw_binary_row(const uint8_t *src, int x, int y, display::Display *display, const uint16_t *colors,
+                       Color color_on);
+  // Format indexé: tables de la palette, puis une ligne d'indices affichée
+  void build_palette(const std::vector<uint8_t> &palette);
+  void draw_indexed_row(const uint8_t *src, int x, int y, display::Display *display);
+  size_t get_stream_buffer_size() const;
   void free_cache();
   bool read_image_from_storage();
   size_t get_memory_usage() const { return this->image_data_.size(); }
@@ -216,6 +529,10 @@ class SdImageLoadAction : public Action<Ts...> {
         std::string path = this->file_path_.value(x...);
         if (!path.empty()) {
           ESP_LOGD("sd_image.load", "Loading image from path: %s", path.c_str());
+          if (this->parent_->is_async_load()) {
+            this->parent_->load_image_async(path);
+            return;
+          }
           if (!this->parent_->load_image_from_path(path)) {
             ESP_LOGE("sd_image.load", "Failed to load image from: %s", path.c_str());
           }
@@ -224,6 +541,10 @@ class SdImageLoadAction : public Action<Ts...> {
       }
       
       ESP_LOGD("sd_image.load", "Loading image from configured path");
+      if (this->parent_->is_async_load()) {
+        this->parent_->load_image_async(this->parent_->get_file_path());
+        return;
+      }
       if (!this->parent_->load_image()) {
         ESP_LOGE("sd_image.load", "Failed to load image from configured path");
       }
@@ -267,6 +588,20 @@ class SdImageUnloadAction : public Action<Ts...> {
   SdImageComponent *parent_{nullptr};
 };
 
+class SdImageLoadCompleteTrigger : public Trigger<> {
+ public:
+  explicit SdImageLoadCompleteTrigger(SdImageComponent *parent) {
+    parent->add_on_load_complete_callback([this]() { this->trigger(); });
+  }
+};
+
+class SdImageLoadErrorTrigger : public Trigger<> {
+ public:
+  explicit SdImageLoadErrorTrigger(SdImageComponent *parent) {
+    parent->add_on_load_error_callback([this]() { this->trigger(); });
+  }
+};
+
 }  // namespace storage
 }  // namespace esphome
 